@@ -187,7 +187,11 @@ fallback_flush_relative_motion(struct fallback_dispatch *dispatch,
 	if (post_button_scroll(device, raw, time))
 		return;
 
-	if (device->pointer.filter) {
+	if (device->pointer.constant_factor != 0.0) {
+		/* Flat profile, no need to go through the filter */
+		accel.x = raw.x * device->pointer.constant_factor;
+		accel.y = raw.y * device->pointer.constant_factor;
+	} else if (device->pointer.filter) {
 		/* Apply pointer acceleration. */
 		accel = filter_dispatch(device->pointer.filter, &raw, device, time);
 	} else {
@@ -619,6 +623,7 @@ fallback_process_touch(struct fallback_dispatch *dispatch,
 		if (e->value >= 0) {
 			dispatch->pending_event |= EVDEV_ABSOLUTE_MT;
 			slot->state = SLOT_STATE_BEGIN;
+			long_set_bit(dispatch->mt.active_slots, dispatch->mt.slot);
 			if (dispatch->mt.has_palm) {
 				int v;
 				v = libevdev_get_slot_value(device->evdev,
@@ -640,19 +645,19 @@ fallback_process_touch(struct fallback_dispatch *dispatch,
 			dispatch->pending_event |= EVDEV_ABSOLUTE_MT;
 			slot->state = SLOT_STATE_END;
 		}
-		slot->dirty = true;
+		long_set_bit(dispatch->mt.dirty_slots, dispatch->mt.slot);
 		break;
 	case EVDEV_ABS_MT_POSITION_X:
 		evdev_device_check_abs_axis_range(device, e->usage, e->value);
 		dispatch->mt.slots[dispatch->mt.slot].point.x = e->value;
 		dispatch->pending_event |= EVDEV_ABSOLUTE_MT;
-		slot->dirty = true;
+		long_set_bit(dispatch->mt.dirty_slots, dispatch->mt.slot);
 		break;
 	case EVDEV_ABS_MT_POSITION_Y:
 		evdev_device_check_abs_axis_range(device, e->usage, e->value);
 		dispatch->mt.slots[dispatch->mt.slot].point.y = e->value;
 		dispatch->pending_event |= EVDEV_ABSOLUTE_MT;
-		slot->dirty = true;
+		long_set_bit(dispatch->mt.dirty_slots, dispatch->mt.slot);
 		break;
 	case EVDEV_ABS_MT_TOOL_TYPE:
 		/* The transitions matter - we (may) need to send a touch
@@ -672,7 +677,7 @@ fallback_process_touch(struct fallback_dispatch *dispatch,
 			break;
 		}
 		dispatch->pending_event |= EVDEV_ABSOLUTE_MT;
-		slot->dirty = true;
+		long_set_bit(dispatch->mt.dirty_slots, dispatch->mt.slot);
 		break;
 	default:
 		break;
@@ -938,13 +943,12 @@ fallback_flush_mt_events(struct fallback_dispatch *dispatch,
 {
 	bool sent = false;
 
-	for (size_t i = 0; i < dispatch->mt.slots_len; i++) {
+	long_for_each_bit_set(dispatch->mt.dirty_slots,
+			      NLONGS(dispatch->mt.slots_len),
+			      i) {
 		struct mt_slot *slot = &dispatch->mt.slots[i];
 
-		if (!slot->dirty)
-			continue;
-
-		slot->dirty = false;
+		long_clear_bit(dispatch->mt.dirty_slots, i);
 
 		/* Any palm state other than PALM_NEW means we've either
 		 * already cancelled the touch or the touch was never
@@ -990,6 +994,7 @@ fallback_flush_mt_events(struct fallback_dispatch *dispatch,
 			break;
 		case SLOT_STATE_END:
 			slot->state = SLOT_STATE_NONE;
+			long_clear_bit(dispatch->mt.active_slots, i);
 			break;
 		case SLOT_STATE_NONE:
 			/* touch arbitration may swallow the begin,
@@ -1042,11 +1047,12 @@ fallback_handle_state(struct fallback_dispatch *dispatch,
 
 	/* Buttons and keys */
 	if (dispatch->pending_event & EVDEV_KEY) {
-		for (evdev_usage_t usage = evdev_usage_from(EVDEV_KEY_RESERVED);
-		     evdev_usage_le(usage, EVDEV_KEY_MAX);
-		     usage = evdev_usage_next(usage)) {
-			if (!hw_key_has_changed(dispatch, usage))
-				continue;
+		unsigned long changed[NLONGS(KEY_CNT)];
+
+		/* Only visit the codes that changed in this frame */
+		hw_key_get_changed(dispatch, changed);
+		long_for_each_bit_set(changed, ARRAY_LENGTH(changed), code) {
+			evdev_usage_t usage = evdev_usage_from_code(EV_KEY, code);
 
 			if (evdev_usage_is_button(usage)) {
 				enum libinput_button_state state =
@@ -1129,7 +1135,6 @@ cancel_touches(struct fallback_dispatch *dispatch,
 	       const struct device_coord_rect *rect,
 	       uint64_t time)
 {
-	unsigned int idx;
 	bool need_frame = false;
 	struct device_coords point;
 
@@ -1138,14 +1143,18 @@ cancel_touches(struct fallback_dispatch *dispatch,
 	if (!rect || point_in_rect(&point, rect))
 		need_frame = fallback_flush_st_cancel(dispatch, device, time);
 
-	for (idx = 0; idx < dispatch->mt.slots_len; idx++) {
+	/* A slot with a seat slot assigned always has an active touch */
+	long_for_each_bit_set(dispatch->mt.active_slots,
+			      NLONGS(dispatch->mt.slots_len),
+			      idx) {
 		struct mt_slot *slot = &dispatch->mt.slots[idx];
-		point = slot->point;
-		evdev_transform_absolute(device, &point);
 
 		if (slot->seat_slot == -1)
 			continue;
 
+		point = slot->point;
+		evdev_transform_absolute(device, &point);
+
 		if ((!rect || point_in_rect(&point, rect)) &&
 		    fallback_flush_mt_cancel(dispatch, device, idx, time))
 			need_frame = true;
@@ -1216,7 +1225,7 @@ fallback_return_to_neutral_state(struct fallback_dispatch *dispatch,
 	cancel_touches(dispatch, device, NULL, time);
 	release_pressed_keys(dispatch, device, time);
 	memset(dispatch->hw_key_mask, 0, sizeof(dispatch->hw_key_mask));
-	memset(dispatch->hw_key_mask, 0, sizeof(dispatch->last_hw_key_mask));
+	memset(dispatch->last_hw_key_mask, 0, sizeof(dispatch->last_hw_key_mask));
 }
 
 static void
@@ -1355,6 +1364,8 @@ fallback_interface_destroy(struct evdev_dispatch *evdev_dispatch)
 	libinput_timer_destroy(&dispatch->debounce.timer_short);
 
 	free(dispatch->mt.slots);
+	free(dispatch->mt.dirty_slots);
+	free(dispatch->mt.active_slots);
 	free(dispatch);
 }
 
@@ -1655,6 +1666,8 @@ fallback_dispatch_init_slots(struct fallback_dispatch *dispatch,
 	}
 	dispatch->mt.slots = slots;
 	dispatch->mt.slots_len = num_slots;
+	dispatch->mt.dirty_slots = zalloc(NLONGS(num_slots) * sizeof(unsigned long));
+	dispatch->mt.active_slots = zalloc(NLONGS(num_slots) * sizeof(unsigned long));
 	dispatch->mt.slot = active_slot;
 	dispatch->mt.has_palm =
 		libevdev_has_event_code(evdev, EV_ABS, ABS_MT_TOOL_TYPE);
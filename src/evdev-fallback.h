@@ -62,7 +62,6 @@ enum palm_state {
 };
 
 struct mt_slot {
-	bool dirty;
 	enum mt_slot_state state;
 	int32_t seat_slot;
 	struct device_coords point;
@@ -91,6 +90,10 @@ struct fallback_dispatch {
 		int slot;
 		struct mt_slot *slots;
 		size_t slots_len;
+		/* Bitmaps of slots changed in the current frame and of slots
+		 * with a touch sequence, NLONGS(slots_len) each */
+		unsigned long *dirty_slots;
+		unsigned long *active_slots;
 		bool want_hysteresis;
 		struct device_coords hysteresis_margin;
 		bool has_palm;
@@ -174,14 +177,12 @@ hw_set_key_down(struct fallback_dispatch *dispatch, evdev_usage_t usage, int pre
 	long_set_bit_state(dispatch->hw_key_mask, code, pressed);
 }
 
-static inline bool
-hw_key_has_changed(struct fallback_dispatch *dispatch, evdev_usage_t usage)
+static inline void
+hw_key_get_changed(struct fallback_dispatch *dispatch,
+		   unsigned long changed[NLONGS(KEY_CNT)])
 {
-	assert(evdev_usage_type(usage) == EV_KEY);
-
-	unsigned int code = evdev_usage_code(usage);
-	return long_bit_is_set(dispatch->hw_key_mask, code) !=
-	       long_bit_is_set(dispatch->last_hw_key_mask, code);
+	for (size_t i = 0; i < NLONGS(KEY_CNT); i++)
+		changed[i] = dispatch->hw_key_mask[i] ^ dispatch->last_hw_key_mask[i];
 }
 
 static inline void
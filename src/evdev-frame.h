@@ -626,6 +626,23 @@ evdev_frame_set(struct evdev_frame *frame,
 	return evdev_frame_append(frame, events, nevents);
 }
 
+/**
+ * Truncate the frame to its first nevents events, the SYN_REPORT is
+ * kept. This allows for filtering a frame in place: move the events to
+ * keep to the front of the array returned by evdev_frame_get_events(),
+ * then truncate to the number of events kept.
+ */
+static inline void
+evdev_frame_truncate(struct evdev_frame *frame, size_t nevents)
+{
+	assert(nevents < frame->count);
+
+	memset(frame->events + nevents,
+	       0,
+	       (frame->count - nevents) * sizeof(*frame->events));
+	frame->count = nevents + 1; /* SYN_REPORT is always there */
+}
+
 static inline struct evdev_frame *
 evdev_frame_clone(struct evdev_frame *frame)
 {
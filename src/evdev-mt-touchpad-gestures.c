@@ -116,11 +116,12 @@ static struct device_float_coords
 tp_get_touches_delta(struct tp_dispatch *tp, bool average)
 {
 	struct tp_touch *t;
-	unsigned int i, nactive = 0;
+	unsigned int nactive = 0;
 	struct device_float_coords delta = { 0.0, 0.0 };
 
-	for (i = 0; i < tp->num_slots; i++) {
-		t = &tp->touches[i];
+	tp_for_each_active_touch(tp, t) {
+		if (t->index >= tp->num_slots)
+			break;
 
 		if (!tp_touch_active_for_gesture(tp, t))
 			continue;
@@ -228,7 +229,7 @@ tp_gesture_get_active_touches(const struct tp_dispatch *tp,
 
 	memset(touches, 0, count * sizeof(struct tp_touch *));
 
-	tp_for_each_touch(tp, t) {
+	tp_for_each_active_touch(tp, t) {
 		if (tp_touch_active_for_gesture(tp, t)) {
 			touches[n++] = t;
 			if (n == count)
@@ -287,11 +288,9 @@ tp_gesture_get_direction(struct tp_dispatch *tp, struct tp_touch *touch)
 }
 
 static void
-tp_gesture_get_pinch_info(struct tp_dispatch *tp,
-			  double *distance,
-			  double *angle,
-			  struct device_float_coords *center)
+tp_gesture_update_pinch_geometry(struct tp_dispatch *tp)
 {
+	struct tp_gesture_geometry *geometry = &tp->gesture.geometry;
 	struct normalized_coords normalized;
 	struct device_float_coords delta;
 	struct tp_touch *first = tp->gesture.touches[0],
@@ -299,22 +298,53 @@ tp_gesture_get_pinch_info(struct tp_dispatch *tp,
 
 	delta = device_delta(first->point, second->point);
 	normalized = tp_normalize_delta(tp, delta);
-	*distance = normalized_length(normalized);
-	*angle = rad2deg(atan2(normalized.y, normalized.x));
+	geometry->distance = normalized_length(normalized);
+	geometry->angle = rad2deg(atan2(normalized.y, normalized.x));
+	geometry->center = device_average(first->point, second->point);
+}
+
+/**
+ * Returns the distance, angle and center of the two pinch touches. These
+ * are only recalculated when one of the two touches moved in this frame,
+ * otherwise the cached values from the last update are returned.
+ */
+static const struct tp_gesture_geometry *
+tp_gesture_get_pinch_info(struct tp_dispatch *tp)
+{
+	if (tp->gesture.touches[0]->dirty || tp->gesture.touches[1]->dirty)
+		tp_gesture_update_pinch_geometry(tp);
 
-	*center = device_average(first->point, second->point);
+	return &tp->gesture.geometry;
 }
 
 static inline void
 tp_gesture_init_pinch(struct tp_dispatch *tp)
 {
-	tp_gesture_get_pinch_info(tp,
-				  &tp->gesture.initial_distance,
-				  &tp->gesture.angle,
-				  &tp->gesture.center);
+	tp_gesture_update_pinch_geometry(tp);
+	tp->gesture.initial_distance = tp->gesture.geometry.distance;
+	tp->gesture.angle = tp->gesture.geometry.angle;
+	tp->gesture.center = tp->gesture.geometry.center;
 	tp->gesture.prev_scale = 1.0;
 }
 
+/**
+ * Returns the change in angle since the last pinch update, unwrapped
+ * into the [-180, 180] range, and updates the stored angle.
+ */
+static inline double
+tp_gesture_pinch_angle_delta(struct tp_dispatch *tp, double angle)
+{
+	double angle_delta = angle - tp->gesture.angle;
+
+	tp->gesture.angle = angle;
+	if (angle_delta > 180.0)
+		angle_delta -= 360.0;
+	else if (angle_delta < -180.0)
+		angle_delta += 360.0;
+
+	return angle_delta;
+}
+
 static inline void
 tp_gesture_init_3fg_drag(struct tp_dispatch *tp, uint64_t time)
 {
@@ -1624,23 +1654,18 @@ static void
 tp_gesture_handle_state_pinch_start(struct tp_dispatch *tp, uint64_t time)
 {
 	const struct normalized_coords zero = { 0.0, 0.0 };
-	double angle, angle_delta, distance, scale;
-	struct device_float_coords center, fdelta;
+	const struct tp_gesture_geometry *geometry;
+	double angle_delta, scale;
+	struct device_float_coords fdelta;
 	struct normalized_coords delta;
 
-	tp_gesture_get_pinch_info(tp, &distance, &angle, &center);
+	geometry = tp_gesture_get_pinch_info(tp);
 
-	scale = distance / tp->gesture.initial_distance;
-
-	angle_delta = angle - tp->gesture.angle;
-	tp->gesture.angle = angle;
-	if (angle_delta > 180.0)
-		angle_delta -= 360.0;
-	else if (angle_delta < -180.0)
-		angle_delta += 360.0;
+	scale = geometry->distance / tp->gesture.initial_distance;
+	angle_delta = tp_gesture_pinch_angle_delta(tp, geometry->angle);
 
-	fdelta = device_float_delta(center, tp->gesture.center);
-	tp->gesture.center = center;
+	fdelta = device_float_delta(geometry->center, tp->gesture.center);
+	tp->gesture.center = geometry->center;
 
 	delta = tp_filter_motion(tp, &fdelta, time);
 
@@ -1664,23 +1689,18 @@ tp_gesture_handle_state_pinch_start(struct tp_dispatch *tp, uint64_t time)
 static void
 tp_gesture_handle_state_pinch(struct tp_dispatch *tp, uint64_t time)
 {
-	double angle, angle_delta, distance, scale;
-	struct device_float_coords center, fdelta;
+	const struct tp_gesture_geometry *geometry;
+	double angle_delta, scale;
+	struct device_float_coords fdelta;
 	struct normalized_coords delta, unaccel;
 
-	tp_gesture_get_pinch_info(tp, &distance, &angle, &center);
-
-	scale = distance / tp->gesture.initial_distance;
+	geometry = tp_gesture_get_pinch_info(tp);
 
-	angle_delta = angle - tp->gesture.angle;
-	tp->gesture.angle = angle;
-	if (angle_delta > 180.0)
-		angle_delta -= 360.0;
-	else if (angle_delta < -180.0)
-		angle_delta += 360.0;
+	scale = geometry->distance / tp->gesture.initial_distance;
+	angle_delta = tp_gesture_pinch_angle_delta(tp, geometry->angle);
 
-	fdelta = device_float_delta(center, tp->gesture.center);
-	tp->gesture.center = center;
+	fdelta = device_float_delta(geometry->center, tp->gesture.center);
+	tp->gesture.center = geometry->center;
 
 	delta = tp_filter_motion(tp, &fdelta, time);
 
@@ -58,6 +58,25 @@ tp_motion_history_offset(struct tp_touch *t, int offset)
 	return &t->history.samples[offset_index];
 }
 
+static inline bool
+tp_accel_is_constant(struct tp_dispatch *tp)
+{
+	return tp->device->pointer.constant_factor != 0.0;
+}
+
+/* Flat profile: motion, unaccelerated motion and scroll motion are all
+ * the same constant factor, no need to go through the filter */
+static inline struct normalized_coords
+tp_filter_constant(struct tp_dispatch *tp, const struct device_float_coords *raw)
+{
+	double factor = tp->device->pointer.constant_factor;
+
+	return (struct normalized_coords){
+		.x = raw->x * factor,
+		.y = raw->y * factor,
+	};
+}
+
 struct normalized_coords
 tp_filter_motion(struct tp_dispatch *tp,
 		 const struct device_float_coords *unaccelerated,
@@ -72,6 +91,9 @@ tp_filter_motion(struct tp_dispatch *tp,
 	/* Convert to device units with x/y in the same resolution */
 	raw = tp_scale_to_xaxis(tp, *unaccelerated);
 
+	if (tp_accel_is_constant(tp))
+		return tp_filter_constant(tp, &raw);
+
 	return filter_dispatch(tp->device->pointer.filter, &raw, tp, time);
 }
 
@@ -89,6 +111,9 @@ tp_filter_motion_unaccelerated(struct tp_dispatch *tp,
 	/* Convert to device units with x/y in the same resolution */
 	raw = tp_scale_to_xaxis(tp, *unaccelerated);
 
+	if (tp_accel_is_constant(tp))
+		return tp_filter_constant(tp, &raw);
+
 	return filter_dispatch_constant(tp->device->pointer.filter, &raw, tp, time);
 }
 
@@ -106,6 +131,9 @@ tp_filter_scroll(struct tp_dispatch *tp,
 	/* Convert to device units with x/y in the same resolution */
 	raw = tp_scale_to_xaxis(tp, *unaccelerated);
 
+	if (tp_accel_is_constant(tp))
+		return tp_filter_constant(tp, &raw);
+
 	return filter_dispatch_scroll(tp->device->pointer.filter, &raw, tp, time);
 }
 
@@ -340,11 +368,12 @@ tp_new_touch(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 	 * don't know if it's a touch down or not. And BTN_TOUCH may happen
 	 * after ABS_MT_TRACKING_ID */
 	tp_motion_history_reset(t);
-	t->dirty = true;
+	tp_touch_set_dirty(tp, t);
 	t->has_ended = false;
 	t->was_down = false;
 	t->palm.state = PALM_NONE;
 	t->state = TOUCH_HOVERING;
+	long_set_bit(tp->active_touches, t->index);
 	t->pinned.is_pinned = false;
 	t->speed.last_speed = 0;
 	t->speed.exceeded_count = 0;
@@ -355,7 +384,7 @@ tp_new_touch(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 static inline void
 tp_begin_touch(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 {
-	t->dirty = true;
+	tp_touch_set_dirty(tp, t);
 	t->state = TOUCH_BEGIN;
 	t->initial_time = time;
 	t->was_down = true;
@@ -400,9 +429,10 @@ tp_maybe_end_touch(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 		t->state = TOUCH_MAYBE_END;
 	} else {
 		t->state = TOUCH_NONE;
+		long_clear_bit(tp->active_touches, t->index);
 	}
 
-	t->dirty = true;
+	tp_touch_set_dirty(tp, t);
 }
 
 /**
@@ -412,7 +442,7 @@ tp_maybe_end_touch(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 static inline void
 tp_recover_ended_touch(struct tp_dispatch *tp, struct tp_touch *t)
 {
-	t->dirty = true;
+	tp_touch_set_dirty(tp, t);
 	t->state = TOUCH_UPDATE;
 	tp->nfingers_down++;
 }
@@ -432,7 +462,7 @@ tp_end_touch(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 		return;
 	}
 
-	t->dirty = true;
+	tp_touch_set_dirty(tp, t);
 	t->palm.state = PALM_NONE;
 	t->state = TOUCH_END;
 	t->pinned.is_pinned = false;
@@ -508,13 +538,13 @@ tp_process_absolute(struct tp_dispatch *tp, const struct evdev_event *e, uint64_
 	case EVDEV_ABS_MT_POSITION_X:
 		evdev_device_check_abs_axis_range(tp->device, e->usage, e->value);
 		t->point.x = rotated(tp, e->usage, e->value);
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t);
 		tp->queued |= TOUCHPAD_EVENT_MOTION;
 		break;
 	case EVDEV_ABS_MT_POSITION_Y:
 		evdev_device_check_abs_axis_range(tp->device, e->usage, e->value);
 		t->point.y = rotated(tp, e->usage, e->value);
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t);
 		tp->queued |= TOUCHPAD_EVENT_MOTION;
 		break;
 	case EVDEV_ABS_MT_SLOT:
@@ -531,22 +561,22 @@ tp_process_absolute(struct tp_dispatch *tp, const struct evdev_event *e, uint64_
 		break;
 	case EVDEV_ABS_MT_PRESSURE:
 		t->pressure = e->value;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t);
 		tp->queued |= TOUCHPAD_EVENT_OTHERAXIS;
 		break;
 	case EVDEV_ABS_MT_TOOL_TYPE:
 		t->is_tool_palm = e->value == MT_TOOL_PALM;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t);
 		tp->queued |= TOUCHPAD_EVENT_OTHERAXIS;
 		break;
 	case EVDEV_ABS_MT_TOUCH_MAJOR:
 		t->major = e->value;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t);
 		tp->queued |= TOUCHPAD_EVENT_OTHERAXIS;
 		break;
 	case EVDEV_ABS_MT_TOUCH_MINOR:
 		t->minor = e->value;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t);
 		tp->queued |= TOUCHPAD_EVENT_OTHERAXIS;
 		break;
 	default:
@@ -565,18 +595,18 @@ tp_process_absolute_st(struct tp_dispatch *tp,
 	case EVDEV_ABS_X:
 		evdev_device_check_abs_axis_range(tp->device, e->usage, e->value);
 		t->point.x = rotated(tp, e->usage, e->value);
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t);
 		tp->queued |= TOUCHPAD_EVENT_MOTION;
 		break;
 	case EVDEV_ABS_Y:
 		evdev_device_check_abs_axis_range(tp->device, e->usage, e->value);
 		t->point.y = rotated(tp, e->usage, e->value);
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t);
 		tp->queued |= TOUCHPAD_EVENT_MOTION;
 		break;
 	case EVDEV_ABS_PRESSURE:
 		t->pressure = e->value;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t);
 		tp->queued |= TOUCHPAD_EVENT_OTHERAXIS;
 		break;
 	default:
@@ -930,7 +960,25 @@ tp_palm_detect_move_out_of_edge(struct tp_dispatch *tp,
 }
 
 static inline bool
-tp_palm_detect_multifinger(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
+tp_palm_count_check(struct tp_dispatch *tp,
+		    enum tp_palm_check check,
+		    bool triggered,
+		    uint64_t *since)
+{
+	uint64_t now;
+
+	now_in_ns(&now);
+	tp->palm.stats[check].evaluated++;
+	if (triggered)
+		tp->palm.stats[check].triggered++;
+	tp->palm.stats[check].time_ns += now - *since;
+	*since = now;
+
+	return triggered;
+}
+
+static inline bool
+tp_palm_other_finger_active(struct tp_dispatch *tp, struct tp_touch *t)
 {
 	struct tp_touch *other;
 
@@ -945,7 +993,7 @@ tp_palm_detect_multifinger(struct tp_dispatch *tp, struct tp_touch *t, uint64_t
 	 * frame the second touch will still be PALM_NONE and thus detected
 	 * here as non-palm touch. This is too niche to worry about for now.
 	 */
-	tp_for_each_touch(tp, other) {
+	tp_for_each_active_touch(tp, other) {
 		if (other == t)
 			continue;
 
@@ -957,6 +1005,19 @@ tp_palm_detect_multifinger(struct tp_dispatch *tp, struct tp_touch *t, uint64_t
 	return false;
 }
 
+static inline bool
+tp_palm_detect_multifinger(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
+{
+	uint64_t since;
+
+	now_in_ns(&since);
+
+	return tp_palm_count_check(tp,
+				   PALM_CHECK_MULTIFINGER,
+				   tp_palm_other_finger_active(tp, t),
+				   &since);
+}
+
 static inline bool
 tp_palm_detect_touch_size_triggered(struct tp_dispatch *tp,
 				    struct tp_touch *t,
@@ -1008,15 +1069,16 @@ tp_palm_detect_edge(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 		return false;
 	}
 
-	if (tp_palm_detect_multifinger(tp, t, time)) {
-		return false;
-	}
-
 	/* palm must start in exclusion zone, it's ok to move into
-	   the zone without being a palm */
+	   the zone without being a palm. Check this first, it's cheaper
+	   than looking at all other touches. */
 	if (t->state != TOUCH_BEGIN || !tp_palm_in_edge(tp, t))
 		return false;
 
+	if (tp_palm_detect_multifinger(tp, t, time)) {
+		return false;
+	}
+
 	if (tp_touch_get_edge(tp, t) & EDGE_RIGHT)
 		return false;
 
@@ -1062,26 +1124,50 @@ tp_palm_detect(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 {
 	const char *palm_state;
 	enum touch_palm_state oldstate = t->palm.state;
+	uint64_t since;
 
-	if (tp_palm_detect_pressure_triggered(tp, t, time))
+	now_in_ns(&since);
+
+	if (tp_palm_count_check(tp,
+				PALM_CHECK_PRESSURE,
+				tp_palm_detect_pressure_triggered(tp, t, time),
+				&since))
 		goto out;
 
-	if (tp_palm_detect_arbitration_triggered(tp, t, time))
+	if (tp_palm_count_check(tp,
+				PALM_CHECK_ARBITRATION,
+				tp_palm_detect_arbitration_triggered(tp, t, time),
+				&since))
 		goto out;
 
-	if (tp_palm_detect_dwt_triggered(tp, t, time))
+	if (tp_palm_count_check(tp,
+				PALM_CHECK_DWT,
+				tp_palm_detect_dwt_triggered(tp, t, time),
+				&since))
 		goto out;
 
-	if (tp_palm_detect_trackpoint_triggered(tp, t, time))
+	if (tp_palm_count_check(tp,
+				PALM_CHECK_TRACKPOINT,
+				tp_palm_detect_trackpoint_triggered(tp, t, time),
+				&since))
 		goto out;
 
-	if (tp_palm_detect_tool_triggered(tp, t, time))
+	if (tp_palm_count_check(tp,
+				PALM_CHECK_TOOL,
+				tp_palm_detect_tool_triggered(tp, t, time),
+				&since))
 		goto out;
 
-	if (tp_palm_detect_touch_size_triggered(tp, t, time))
+	if (tp_palm_count_check(tp,
+				PALM_CHECK_TOUCH_SIZE,
+				tp_palm_detect_touch_size_triggered(tp, t, time),
+				&since))
 		goto out;
 
-	if (tp_palm_detect_edge(tp, t, time))
+	if (tp_palm_count_check(tp,
+				PALM_CHECK_EDGE,
+				tp_palm_detect_edge(tp, t, time),
+				&since))
 		goto out;
 
 	/* Pressure is highest priority because it cannot be released and
@@ -1090,7 +1176,10 @@ tp_palm_detect(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 	 * everything in case one of the others released but we have a
 	 * pressure trigger now.
 	 */
-	if (tp_palm_detect_pressure_triggered(tp, t, time))
+	if (tp_palm_count_check(tp,
+				PALM_CHECK_PRESSURE,
+				tp_palm_detect_pressure_triggered(tp, t, time),
+				&since))
 		goto out;
 
 	return;
@@ -1358,8 +1447,8 @@ tp_position_fake_touches(struct tp_dispatch *tp)
 
 		t->point = topmost->point;
 		t->pressure = topmost->pressure;
-		if (!t->dirty)
-			t->dirty = topmost->dirty;
+		if (!t->dirty && topmost->dirty)
+			tp_touch_set_dirty(tp, t);
 	}
 }
 
@@ -1631,10 +1720,7 @@ tp_process_state(struct tp_dispatch *tp, uint64_t time)
 
 	want_motion_reset = tp_need_motion_history_reset(tp);
 
-	tp_for_each_touch(tp, t) {
-		if (t->state == TOUCH_NONE)
-			continue;
-
+	tp_for_each_active_touch(tp, t) {
 		if (want_motion_reset) {
 			tp_motion_history_reset(t);
 			t->quirks.reset_motion_history = true;
@@ -1734,22 +1820,21 @@ tp_post_process_state(struct tp_dispatch *tp, uint64_t time)
 {
 	struct tp_touch *t;
 
-	tp_for_each_touch(tp, t) {
-
-		if (!t->dirty)
-			continue;
-
+	tp_for_each_dirty_touch(tp, t) {
 		if (t->state == TOUCH_END) {
-			if (t->has_ended)
+			if (t->has_ended) {
 				t->state = TOUCH_NONE;
-			else
+				long_clear_bit(tp->active_touches, t->index);
+			} else {
 				t->state = TOUCH_HOVERING;
+			}
 		} else if (t->state == TOUCH_BEGIN) {
 			t->state = TOUCH_UPDATE;
 		}
 
 		t->dirty = false;
 	}
+	memset(tp->dirty_touches, 0, NLONGS(tp->ntouches) * sizeof(unsigned long));
 
 	tp->old_nfingers_down = tp->nfingers_down;
 	tp->buttons.old_state = tp->buttons.state;
@@ -1965,6 +2050,8 @@ tp_interface_destroy(struct evdev_dispatch *dispatch)
 	libinput_timer_destroy(&tp->gesture.hold_timer);
 	libinput_timer_destroy(&tp->gesture.drag_3fg_timer);
 	free(tp->touches);
+	free(tp->dirty_touches);
+	free(tp->active_touches);
 	free(tp);
 }
 
@@ -2165,51 +2252,44 @@ tp_keyboard_timeout(uint64_t now, void *data)
 	evdev_log_debug(tp->device, "palm: keyboard timeout\n");
 }
 
-static inline bool
-tp_key_is_shift(unsigned int keycode)
-{
-	return keycode == KEY_LEFTSHIFT || keycode == KEY_RIGHTSHIFT;
-}
+enum dwt_key_class {
+	DWT_KEY_TYPING,   /* part of the "typewriter set" */
+	DWT_KEY_IGNORED,  /* F-keys, multimedia keys, numpad, etc. */
+	DWT_KEY_MODIFIER,
+	DWT_KEY_SHIFT,
+};
 
-static inline bool
-tp_key_is_modifier(unsigned int keycode)
+/**
+ * Classify a key for disable-while-typing in a single switch, this is
+ * called for every key press on every paired keyboard.
+ */
+static inline enum dwt_key_class
+tp_dwt_key_class(unsigned int keycode)
 {
 	switch (keycode) {
 	/* Ignore modifiers to be responsive to ctrl-click, alt-tab, etc. */
+	case KEY_LEFTSHIFT:
+	case KEY_RIGHTSHIFT:
+		return DWT_KEY_SHIFT;
 	case KEY_LEFTCTRL:
 	case KEY_RIGHTCTRL:
 	case KEY_LEFTALT:
 	case KEY_RIGHTALT:
-	case KEY_LEFTSHIFT:
-	case KEY_RIGHTSHIFT:
 	case KEY_FN:
 	case KEY_CAPSLOCK:
 	case KEY_TAB:
 	case KEY_COMPOSE:
 	case KEY_RIGHTMETA:
 	case KEY_LEFTMETA:
-		return true;
-	default:
-		return false;
-	}
-}
-
-static inline bool
-tp_key_ignore_for_dwt(unsigned int keycode)
-{
+		return DWT_KEY_MODIFIER;
 	/* Ignore keys not part of the "typewriter set", i.e. F-keys,
 	 * multimedia keys, numpad, etc.
 	 */
-
-	if (tp_key_is_modifier(keycode))
-		return false;
-
-	switch (keycode) {
 	case KEY_ESC:
 	case KEY_KPASTERISK:
-		return true;
+		return DWT_KEY_IGNORED;
 	default:
-		return keycode >= KEY_F1;
+		return keycode >= KEY_F1 ? DWT_KEY_IGNORED : DWT_KEY_TYPING;
 	}
 }
 
@@ -2220,7 +2300,6 @@ tp_keyboard_event(uint64_t time, struct libinput_event *event, void *data)
 	struct libinput_event_keyboard *kbdev;
 	unsigned int timeout;
 	unsigned int key;
-	bool is_modifier;
 
 	if (event->type != LIBINPUT_EVENT_KEYBOARD_KEY)
 		return;
@@ -2239,19 +2318,20 @@ tp_keyboard_event(uint64_t time, struct libinput_event *event, void *data)
 	if (!tp->dwt.dwt_enabled)
 		return;
 
-	if (tp_key_ignore_for_dwt(key))
-		return;
-
 	/* modifier keys don't trigger disable-while-typing so things like
 	 * ctrl+zoom or ctrl+click are possible.
 	 * The exception is shift which we don't trigger DWT for on its own
 	 * but we do trigger DWT for once we type some other key.
 	 */
-	is_modifier = tp_key_is_modifier(key);
-	if (is_modifier) {
-		if (!tp_key_is_shift(key))
-			long_set_bit(tp->dwt.mod_mask, key);
+	switch (tp_dwt_key_class(key)) {
+	case DWT_KEY_IGNORED:
+	case DWT_KEY_SHIFT:
+		return;
+	case DWT_KEY_MODIFIER:
+		long_set_bit(tp->dwt.mod_mask, key);
 		return;
+	case DWT_KEY_TYPING:
+		break;
 	}
 
 	if (!tp->dwt.keyboard_active) {
@@ -2468,6 +2548,80 @@ tp_pair_tablet_mode_switch(struct evdev_device *touchpad,
 	}
 }
 
+static bool
+tp_requires_rotation(struct tp_dispatch *tp, struct evdev_device *device)
+{
+	bool rotate = false;
+#ifdef HAVE_LIBWACOM
+	struct libinput *li = tp_libinput_context(tp);
+	WacomDeviceDatabase *db = NULL;
+	WacomDevice **devices = NULL, **d;
+	WacomDevice *dev;
+	uint32_t vid = evdev_device_get_id_vendor(device),
+		 pid = evdev_device_get_id_product(device);
+
+	if ((device->tags & EVDEV_TAG_TABLET_TOUCHPAD) == 0)
+		goto out;
+
+	db = libinput_libwacom_ref(li);
+	if (!db)
+		goto out;
+
+	/* Check if we have a device with the same vid/pid. If not,
+	   we need to loop through all devices and check their paired
+	   device. */
+	dev = libwacom_new_from_usbid(db, vid, pid, NULL);
+	if (dev) {
+		rotate = libwacom_is_reversible(dev);
+		libwacom_destroy(dev);
+		goto out;
+	}
+
+	devices = libwacom_list_devices_from_database(db, NULL);
+	if (!devices)
+		goto out;
+	d = devices;
+	while (*d) {
+		const WacomMatch *paired;
+
+		paired = libwacom_get_paired_device(*d);
+		if (paired && libwacom_match_get_vendor_id(paired) == vid &&
+		    libwacom_match_get_product_id(paired) == pid) {
+			rotate = libwacom_is_reversible(dev);
+			break;
+		}
+		d++;
+	}
+
+	free(devices);
+
+out:
+	/* We don't need to keep it around for the touchpad, we're done with
+	 * it until the device dies. */
+	if (db)
+		libinput_libwacom_unref(li);
+#endif
+
+	return rotate;
+}
+
+/**
+ * Whether this touchpad rotates with its tablet. This needs a lookup in
+ * the libwacom database, so it's done on first use rather than in
+ * tp_init(): most touchpads never pair with a tablet or get set to
+ * left-handed.
+ */
+static bool
+tp_must_rotate(struct tp_dispatch *tp)
+{
+	if (!tp->left_handed.must_rotate_checked) {
+		tp->left_handed.must_rotate = tp_requires_rotation(tp, tp->device);
+		tp->left_handed.must_rotate_checked = true;
+	}
+
+	return tp->left_handed.must_rotate;
+}
+
 static void
 tp_change_rotation(struct evdev_device *device, enum notify notify)
 {
@@ -2475,7 +2629,7 @@ tp_change_rotation(struct evdev_device *device, enum notify notify)
 	struct evdev_device *tablet_device = tp->left_handed.tablet_device;
 	bool tablet_is_left, touchpad_is_left;
 
-	if (!tp->left_handed.must_rotate)
+	if (!tp_must_rotate(tp))
 		return;
 
 	touchpad_is_left = device->left_handed.enabled;
@@ -2501,9 +2655,6 @@ tp_pair_tablet(struct evdev_device *touchpad, struct evdev_device *tablet)
 {
 	struct tp_dispatch *tp = (struct tp_dispatch *)touchpad->dispatch;
 
-	if (!tp->left_handed.must_rotate)
-		return;
-
 	if ((tablet->seat_caps & EVDEV_DEVICE_TABLET) == 0)
 		return;
 
@@ -2511,6 +2662,9 @@ tp_pair_tablet(struct evdev_device *touchpad, struct evdev_device *tablet)
 	    libinput_device_get_device_group(&tablet->base))
 		return;
 
+	if (!tp_must_rotate(tp))
+		return;
+
 	tp->left_handed.tablet_device = tablet;
 
 	evdev_log_debug(touchpad,
@@ -2854,6 +3008,8 @@ tp_init_slots(struct tp_dispatch *tp, struct evdev_device *device)
 
 	tp->ntouches = max(tp->num_slots, n_btn_tool_touches);
 	tp->touches = zalloc(tp->ntouches * sizeof(struct tp_touch));
+	tp->dirty_touches = zalloc(NLONGS(tp->ntouches) * sizeof(unsigned long));
+	tp->active_touches = zalloc(NLONGS(tp->ntouches) * sizeof(unsigned long));
 
 	for (i = 0; i < tp->ntouches; i++)
 		tp_init_touch(tp, &tp->touches[i], i);
@@ -2937,6 +3093,8 @@ tp_accel_config_set_speed(struct libinput_device *device, double speed)
 	if (!filter_set_speed(dev->pointer.filter, speed))
 		return LIBINPUT_CONFIG_STATUS_INVALID;
 
+	evdev_device_update_accel_constant_factor(dev);
+
 	return LIBINPUT_CONFIG_STATUS_SUCCESS;
 }
 
@@ -3754,76 +3912,48 @@ tp_change_to_left_handed(struct evdev_device *device)
 	tp_change_rotation(device, DO_NOTIFY);
 }
 
-static bool
-tp_requires_rotation(struct tp_dispatch *tp, struct evdev_device *device)
-{
-	bool rotate = false;
-#ifdef HAVE_LIBWACOM
-	struct libinput *li = tp_libinput_context(tp);
-	WacomDeviceDatabase *db = NULL;
-	WacomDevice **devices = NULL, **d;
-	WacomDevice *dev;
-	uint32_t vid = evdev_device_get_id_vendor(device),
-		 pid = evdev_device_get_id_product(device);
-
-	if ((device->tags & EVDEV_TAG_TABLET_TOUCHPAD) == 0)
-		goto out;
-
-	db = libinput_libwacom_ref(li);
-	if (!db)
-		goto out;
-
-	/* Check if we have a device with the same vid/pid. If not,
-	   we need to loop through all devices and check their paired
-	   device. */
-	dev = libwacom_new_from_usbid(db, vid, pid, NULL);
-	if (dev) {
-		rotate = libwacom_is_reversible(dev);
-		libwacom_destroy(dev);
-		goto out;
-	}
-
-	devices = libwacom_list_devices_from_database(db, NULL);
-	if (!devices)
-		goto out;
-	d = devices;
-	while (*d) {
-		const WacomMatch *paired;
-
-		paired = libwacom_get_paired_device(*d);
-		if (paired && libwacom_match_get_vendor_id(paired) == vid &&
-		    libwacom_match_get_product_id(paired) == pid) {
-			rotate = libwacom_is_reversible(dev);
-			break;
-		}
-		d++;
-	}
-
-	free(devices);
-
-out:
-	/* We don't need to keep it around for the touchpad, we're done with
-	 * it until the device dies. */
-	if (db)
-		libinput_libwacom_unref(li);
-#endif
-
-	return rotate;
-}
-
 static void
 tp_init_left_handed(struct tp_dispatch *tp, struct evdev_device *device)
 {
 	bool want_left_handed = true;
 
-	tp->left_handed.must_rotate = tp_requires_rotation(tp, device);
-
 	if (device->model_flags & EVDEV_MODEL_APPLE_TOUCHPAD_ONEBUTTON)
 		want_left_handed = false;
 	if (want_left_handed)
 		evdev_init_left_handed(device, tp_change_to_left_handed);
 }
 
+void
+evdev_device_touchpad_palm_stats_dump(struct evdev_device *device,
+				      libinput_palm_stats_func func,
+				      void *user_data)
+{
+	static const char *names[PALM_CHECK_COUNT] = {
+		[PALM_CHECK_PRESSURE] = "pressure",
+		[PALM_CHECK_ARBITRATION] = "arbitration",
+		[PALM_CHECK_DWT] = "dwt",
+		[PALM_CHECK_TRACKPOINT] = "trackpoint",
+		[PALM_CHECK_TOOL] = "tool",
+		[PALM_CHECK_TOUCH_SIZE] = "touch-size",
+		[PALM_CHECK_EDGE] = "edge",
+		[PALM_CHECK_MULTIFINGER] = "multifinger",
+	};
+	struct tp_dispatch *tp;
+
+	if (device->dispatch->dispatch_type != DISPATCH_TOUCHPAD)
+		return;
+
+	tp = tp_dispatch(device->dispatch);
+	for (size_t i = 0; i < PALM_CHECK_COUNT; i++) {
+		func(&device->base,
+		     names[i],
+		     tp->palm.stats[i].evaluated,
+		     tp->palm.stats[i].triggered,
+		     tp->palm.stats[i].time_ns,
+		     user_data);
+	}
+}
+
 struct evdev_dispatch *
 evdev_mt_touchpad_create(struct evdev_device *device)
 {
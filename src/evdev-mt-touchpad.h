@@ -78,6 +78,19 @@ enum touch_palm_state {
 	PALM_ARBITRATION,
 };
 
+/* The individual checks in tp_palm_detect(), for the palm stats */
+enum tp_palm_check {
+	PALM_CHECK_PRESSURE,
+	PALM_CHECK_ARBITRATION,
+	PALM_CHECK_DWT,
+	PALM_CHECK_TRACKPOINT,
+	PALM_CHECK_TOOL,
+	PALM_CHECK_TOUCH_SIZE,
+	PALM_CHECK_EDGE,
+	PALM_CHECK_MULTIFINGER,
+	PALM_CHECK_COUNT,
+};
+
 enum button_event {
 	BUTTON_EVENT_IN_BOTTOM_R = 30,
 	BUTTON_EVENT_IN_BOTTOM_M,
@@ -309,6 +322,10 @@ struct tp_dispatch {
 	unsigned int num_slots;     /* number of slots */
 	unsigned int ntouches;      /* no slots inc. fakes */
 	struct tp_touch *touches;   /* len == ntouches */
+	/* Bitmaps of dirty touches and touches not in TOUCH_NONE,
+	 * NLONGS(ntouches) each */
+	unsigned long *dirty_touches;
+	unsigned long *active_touches;
 	/* bit 0: BTN_TOUCH
 	 * bit 1: BTN_TOOL_FINGER
 	 * bit 2: BTN_TOOL_DOUBLETAP
@@ -366,6 +383,13 @@ struct tp_dispatch {
 		double prev_scale;
 		double angle;
 		struct device_float_coords center;
+		/* Pinch geometry of touches[0] and touches[1], updated only
+		 * when one of the two moves */
+		struct tp_gesture_geometry {
+			double distance;
+			double angle;
+			struct device_float_coords center;
+		} geometry;
 		struct libinput_timer hold_timer;
 		bool hold_enabled;
 
@@ -476,6 +500,12 @@ struct tp_dispatch {
 
 		bool use_size;
 		int size_threshold;
+
+		struct {
+			uint64_t evaluated;
+			uint64_t triggered;
+			uint64_t time_ns; /* includes nested checks */
+		} stats[PALM_CHECK_COUNT];
 	} palm;
 
 	struct {
@@ -549,6 +579,7 @@ struct tp_dispatch {
 		bool want_rotate;
 
 		bool must_rotate; /* true if we should rotate when applicable */
+		bool must_rotate_checked; /* see tp_must_rotate() */
 		struct evdev_device *tablet_device;
 		bool tablet_left_handed_state;
 	} left_handed;
@@ -565,6 +596,26 @@ tp_dispatch(struct evdev_dispatch *dispatch)
 #define tp_for_each_touch(_tp, _t) \
 	for (unsigned int _i = 0; _i < (_tp)->ntouches && (_t = &(_tp)->touches[_i]); _i++)
 
+#define _tp_for_each_touch_in(_tp, _t, _bits) \
+	for (int _i = long_bit_find_next_set(_bits, NLONGS((_tp)->ntouches), 0); \
+	     _i >= 0 && (_t = &(_tp)->touches[_i]); \
+	     _i = long_bit_find_next_set(_bits, NLONGS((_tp)->ntouches), _i + 1))
+
+/* Touches that are not in TOUCH_NONE */
+#define tp_for_each_active_touch(_tp, _t) \
+	_tp_for_each_touch_in(_tp, _t, (_tp)->active_touches)
+
+/* Touches that changed in this frame */
+#define tp_for_each_dirty_touch(_tp, _t) \
+	_tp_for_each_touch_in(_tp, _t, (_tp)->dirty_touches)
+
+static inline void
+tp_touch_set_dirty(struct tp_dispatch *tp, struct tp_touch *t)
+{
+	t->dirty = true;
+	long_set_bit(tp->dirty_touches, t->index);
+}
+
 static inline struct libinput *
 tp_libinput_context(const struct tp_dispatch *tp)
 {
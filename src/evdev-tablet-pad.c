@@ -780,6 +780,9 @@ pad_init(struct pad_dispatch *pad, struct evdev_device *device)
 			 sizeof(event_path),
 			 "/dev/input/%s",
 			 evdev_device_get_sysname(device));
+		size_t span = libinput_trace_begin(li,
+						   evdev_device_get_sysname(device),
+						   "libwacom lookup");
 		wacom = libwacom_new_from_path(db, event_path, WFALLBACK_NONE, NULL);
 		if (!wacom) {
 			wacom = libwacom_new_from_usbid(
@@ -788,6 +791,7 @@ pad_init(struct pad_dispatch *pad, struct evdev_device *device)
 				evdev_device_get_id_product(device),
 				NULL);
 		}
+		libinput_trace_end(li, span);
 		if (!wacom) {
 			evdev_log_info(
 				device,
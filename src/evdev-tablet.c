@@ -24,6 +24,7 @@
 #include "config.h"
 
 #include <assert.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <string.h>
 
@@ -103,34 +104,50 @@ tablet_history_reset(struct tablet_dispatch *tablet)
 	tablet->history.count = 0;
 }
 
-static inline void
-tablet_history_push(struct tablet_dispatch *tablet, const struct tablet_axes *axes)
-{
-	unsigned int index = (tablet->history.index + 1) % tablet_history_size(tablet);
-
-	tablet->history.samples[index] = *axes;
-	tablet->history.index = index;
-	tablet->history.count =
-		min(tablet->history.count + 1, tablet_history_size(tablet));
-
-	if (tablet->history.count < tablet_history_size(tablet))
-		tablet_history_push(tablet, axes);
-}
-
 /**
- * Return a previous axis state, where index of 0 means "most recent", 1 is
- * "one before most recent", etc.
+ * Push a new axis state into the history, evicting the oldest one. An
+ * empty history is filled up entirely with the new state so there is
+ * always a full history to smoothen over.
  */
-static inline const struct tablet_axes *
-tablet_history_get(const struct tablet_dispatch *tablet, unsigned int index)
+static inline void
+tablet_history_push(struct tablet_dispatch *tablet, const struct tablet_axes *axes)
 {
 	size_t sz = tablet_history_size(tablet);
+	unsigned int index = (tablet->history.index + 1) % sz;
+
+	if (tablet->history.count == 0) {
+		for (size_t i = 0; i < sz; i++)
+			tablet->history.samples[i] = *axes;
+		tablet->history.point_sum.x = axes->point.x * (int)sz;
+		tablet->history.point_sum.y = axes->point.y * (int)sz;
+		tablet->history.tilt_sum.x = axes->tilt.x * sz;
+		tablet->history.tilt_sum.y = axes->tilt.y * sz;
+		tablet->history.count = sz;
+	} else {
+		const struct tablet_axes *oldest = &tablet->history.samples[index];
+
+		tablet->history.point_sum.x += axes->point.x - oldest->point.x;
+		tablet->history.point_sum.y += axes->point.y - oldest->point.y;
+		tablet->history.tilt_sum.x += axes->tilt.x - oldest->tilt.x;
+		tablet->history.tilt_sum.y += axes->tilt.y - oldest->tilt.y;
+		tablet->history.samples[index] = *axes;
+
+		/* Unlike the point sum the tilt sum is a double and picks up
+		 * rounding errors with every add and subtract. Sum it up
+		 * again once per pass through the history so those errors
+		 * can't build up over a long stroke */
+		if (index == 0) {
+			struct tilt_degrees sum = { 0.0, 0.0 };
+
+			for (size_t i = 0; i < sz; i++) {
+				sum.x += tablet->history.samples[i].tilt.x;
+				sum.y += tablet->history.samples[i].tilt.y;
+			}
+			tablet->history.tilt_sum = sum;
+		}
+	}
 
-	assert(index < sz);
-	assert(index < tablet->history.count);
-
-	index = (tablet->history.index + sz - index) % sz;
-	return &tablet->history.samples[index];
+	tablet->history.index = index;
 }
 
 static inline void
@@ -733,25 +750,13 @@ tablet_update_wheel(struct tablet_dispatch *tablet, struct evdev_device *device)
 static void
 tablet_smoothen_axes(const struct tablet_dispatch *tablet, struct tablet_axes *axes)
 {
-	size_t i;
-	size_t count = tablet_history_size(tablet);
-	struct tablet_axes smooth = { 0 };
-
-	for (i = 0; i < count; i++) {
-		const struct tablet_axes *a = tablet_history_get(tablet, i);
-
-		smooth.point.x += a->point.x;
-		smooth.point.y += a->point.y;
+	int count = tablet_history_size(tablet);
 
-		smooth.tilt.x += a->tilt.x;
-		smooth.tilt.y += a->tilt.y;
-	}
-
-	axes->point.x = smooth.point.x / count;
-	axes->point.y = smooth.point.y / count;
+	axes->point.x = tablet->history.point_sum.x / count;
+	axes->point.y = tablet->history.point_sum.y / count;
 
-	axes->tilt.x = smooth.tilt.x / count;
-	axes->tilt.y = smooth.tilt.y / count;
+	axes->tilt.x = tablet->history.tilt_sum.x / count;
+	axes->tilt.y = tablet->history.tilt_sum.y / count;
 }
 
 static bool
@@ -1443,6 +1448,7 @@ tablet_new_tool(struct tablet_dispatch *tablet,
 		.config.eraser_button.get_default_button =
 			eraser_button_get_default_button,
 	};
+	list_init(&tool->table_link);
 
 	tool_init_pressure_thresholds(tablet, tool, &tool->pressure.threshold);
 	tool_set_bits(tablet, tool, s);
@@ -1461,15 +1467,19 @@ tablet_get_tool(struct tablet_dispatch *tablet,
 	struct libinput *libinput = tablet_libinput_context(tablet);
 	struct libinput_tablet_tool *tool = NULL, *t;
 	struct list *tool_list;
+	struct list *bucket = NULL;
 
 	if (serial) {
 		tool_list = &libinput->tool_list;
 		/* Check if we already have the tool in our list of tools */
-		list_for_each(t, tool_list, link) {
+		bucket = libinput_tool_table_bucket(libinput, type, serial);
+		libinput->tool_table_stats.lookups++;
+		list_for_each(t, bucket, table_link) {
 			if (type == t->type && serial == t->serial) {
 				tool = t;
 				break;
 			}
+			libinput->tool_table_stats.collisions++;
 		}
 	}
 
@@ -1504,6 +1514,16 @@ tablet_get_tool(struct tablet_dispatch *tablet,
 	if (!tool) {
 		tool = tablet_new_tool(tablet, type, tool_id, serial);
 		list_insert(tool_list, &tool->link);
+		if (tool_list == &libinput->tool_list) {
+			list_insert(bucket, &tool->table_link);
+			evdev_log_debug(device,
+					"tool table: %" PRIu64 " lookups, %" PRIu64
+					" collisions, bucket of serial %#x has %zu tools\n",
+					libinput->tool_table_stats.lookups,
+					libinput->tool_table_stats.collisions,
+					serial,
+					list_length(bucket));
+		}
 	}
 
 	struct libinput_device *last = tool->last_device;
@@ -2708,6 +2728,51 @@ tablet_init_area(struct tablet_dispatch *tablet, struct evdev_device *device)
 	}
 }
 
+static int
+tablet_axis_coalescing_is_available(struct libinput_device *device)
+{
+	return 1;
+}
+
+static enum libinput_config_status
+tablet_axis_coalescing_set_enabled(struct libinput_device *device,
+				   enum libinput_config_axis_coalescing_state enable)
+{
+	struct evdev_device *evdev = evdev_device(device);
+	struct tablet_dispatch *tablet = tablet_dispatch(evdev->dispatch);
+
+	tablet->coalescing.state = enable;
+
+	return LIBINPUT_CONFIG_STATUS_SUCCESS;
+}
+
+static enum libinput_config_axis_coalescing_state
+tablet_axis_coalescing_get_enabled(struct libinput_device *device)
+{
+	struct evdev_device *evdev = evdev_device(device);
+	struct tablet_dispatch *tablet = tablet_dispatch(evdev->dispatch);
+
+	return tablet->coalescing.state;
+}
+
+static enum libinput_config_axis_coalescing_state
+tablet_axis_coalescing_get_default_enabled(struct libinput_device *device)
+{
+	return LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED;
+}
+
+static void
+tablet_init_axis_coalescing(struct tablet_dispatch *tablet, struct evdev_device *device)
+{
+	tablet->coalescing.state = LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED;
+	tablet->coalescing.config.is_available = tablet_axis_coalescing_is_available;
+	tablet->coalescing.config.set_enabled = tablet_axis_coalescing_set_enabled;
+	tablet->coalescing.config.get_enabled = tablet_axis_coalescing_get_enabled;
+	tablet->coalescing.config.get_default_enabled =
+		tablet_axis_coalescing_get_default_enabled;
+	device->base.config.axis_coalescing = &tablet->coalescing.config;
+}
+
 static void
 tablet_init_proximity_threshold(struct tablet_dispatch *tablet,
 				struct evdev_device *device)
@@ -2951,6 +3016,9 @@ tablet_init(struct tablet_dispatch *tablet, struct evdev_device *device)
 			 sizeof(event_path),
 			 "/dev/input/%s",
 			 evdev_device_get_sysname(device));
+		size_t span = libinput_trace_begin(li,
+						   evdev_device_get_sysname(device),
+						   "libwacom lookup");
 		wacom = libwacom_new_from_path(db, event_path, WFALLBACK_NONE, NULL);
 		if (!wacom) {
 			wacom = libwacom_new_from_usbid(
@@ -2959,6 +3027,7 @@ tablet_init(struct tablet_dispatch *tablet, struct evdev_device *device)
 				evdev_device_get_id_product(device),
 				NULL);
 		}
+		libinput_trace_end(li, span);
 		if (!wacom) {
 			evdev_log_info(
 				device,
@@ -2999,6 +3068,7 @@ tablet_init(struct tablet_dispatch *tablet, struct evdev_device *device)
 	tablet_fix_tilt(tablet, device);
 	tablet_init_calibration(tablet, device, is_display_tablet);
 	tablet_init_area(tablet, device);
+	tablet_init_axis_coalescing(tablet, device);
 	tablet_init_proximity_threshold(tablet, device);
 	rc = tablet_init_accel(tablet, device);
 	if (rc != 0)
@@ -72,6 +72,9 @@ struct tablet_dispatch {
 		unsigned int count;
 		struct tablet_axes samples[TABLET_HISTORY_LENGTH];
 		size_t size;
+		/* Sums of point and tilt over all samples, updated on push */
+		struct device_coords point_sum;
+		struct tilt_degrees tilt_sum;
 	} history;
 
 	unsigned char axis_caps[NCHARS(LIBINPUT_TABLET_TOOL_AXIS_MAX + 1)];
@@ -104,6 +107,11 @@ struct tablet_dispatch {
 		struct input_absinfo y;
 	} area;
 
+	struct {
+		struct libinput_device_config_axis_coalescing config;
+		enum libinput_config_axis_coalescing_state state;
+	} coalescing;
+
 	/* The paired touch device on devices with both pen & touch */
 	struct evdev_device *touch_device;
 	enum evdev_arbitration_state arbitration;
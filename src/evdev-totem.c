@@ -88,6 +88,7 @@ totem_new_tool(struct totem_dispatch *totem)
 		.tool_id = 0,
 		.refcount = 1,
 	};
+	list_init(&tool->table_link);
 
 	tool->pressure.threshold.tablet_id = 0;
 	tool->pressure.threshold.offset = pressure_offset_from_double(0.0);
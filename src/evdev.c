@@ -359,15 +359,6 @@ evdev_device_led_update(struct evdev_device *device, enum libinput_led leds)
 	(void)i; /* no, we really don't care about the return value */
 }
 
-void
-evdev_transform_absolute(struct evdev_device *device, struct device_coords *point)
-{
-	if (!device->abs.apply_calibration)
-		return;
-
-	matrix_mult_vec(&device->abs.calibration, &point->x, &point->y);
-}
-
 void
 evdev_transform_relative(struct evdev_device *device, struct device_coords *point)
 {
@@ -1160,6 +1151,8 @@ evdev_accel_config_set_speed(struct libinput_device *device, double speed)
 	if (!filter_set_speed(dev->pointer.filter, speed))
 		return LIBINPUT_CONFIG_STATUS_INVALID;
 
+	evdev_device_update_accel_constant_factor(dev);
+
 	return LIBINPUT_CONFIG_STATUS_SUCCESS;
 }
 
@@ -1248,14 +1241,29 @@ evdev_set_accel_config(struct libinput_device *libinput_device,
 	if (!filter_set_accel_config(dev->pointer.filter, accel_config))
 		return LIBINPUT_CONFIG_STATUS_INVALID;
 
+	evdev_device_update_accel_constant_factor(dev);
+
 	return LIBINPUT_CONFIG_STATUS_SUCCESS;
 }
 
+void
+evdev_device_update_accel_constant_factor(struct evdev_device *device)
+{
+	struct motion_filter *filter = device->pointer.filter;
+
+	/* Flat profiles are a constant factor (with the dpi normalization
+	 * folded in), the motion flush functions apply that directly
+	 * instead of going through the filter */
+	device->pointer.constant_factor =
+		filter ? filter_get_constant_factor(filter) : 0.0;
+}
+
 void
 evdev_device_init_pointer_acceleration(struct evdev_device *device,
 				       struct motion_filter *filter)
 {
 	device->pointer.filter = filter;
+	evdev_device_update_accel_constant_factor(device);
 
 	if (device->base.config.accel == NULL) {
 		double default_speed;
@@ -2247,6 +2255,8 @@ evdev_device_create(struct libinput_seat *seat, struct udev_device *udev_device)
 	int unhandled_device = 0;
 	const char *devnode = udev_device_get_devnode(udev_device);
 	_autofree_ char *sysname = str_sanitize(udev_device_get_sysname(udev_device));
+	uint64_t start;
+	size_t span;
 
 	if (!devnode) {
 		log_info(libinput, "%s: no device node associated\n", sysname);
@@ -2261,7 +2271,9 @@ evdev_device_create(struct libinput_seat *seat, struct udev_device *udev_device)
 	/* Use non-blocking mode so that we can loop on read on
 	 * evdev_device_data() until all events on the fd are
 	 * read. */
+	span = libinput_trace_begin(libinput, sysname, "open");
 	fd = open_restricted(libinput, devnode, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+	libinput_trace_end(libinput, span);
 	if (fd < 0) {
 		log_info(libinput,
 			 "%s: opening input device '%s' failed (%s).\n",
@@ -2274,15 +2286,18 @@ evdev_device_create(struct libinput_seat *seat, struct udev_device *udev_device)
 	if (!evdev_device_have_same_syspath(udev_device, fd))
 		goto err;
 
+	start = libinput_now(libinput);
+
 	device = zalloc(sizeof *device);
 	device->sysname = steal(&sysname);
 
 	libinput_device_init(&device->base, seat);
 	libinput_seat_ref(seat);
 
+	span = libinput_trace_begin(libinput, device->sysname, "libevdev");
 	evdev_drain_fd(fd);
-
 	rc = libevdev_new_from_fd(fd, &device->evdev);
+	libinput_trace_end(libinput, span);
 	if (rc != 0)
 		goto err;
 
@@ -2303,6 +2318,13 @@ evdev_device_create(struct libinput_seat *seat, struct udev_device *udev_device)
 	device->scroll.threshold = 5.0;                /* Default may be overridden */
 	device->scroll.direction_lock_threshold = 5.0; /* Default may be overridden */
 	device->scroll.direction = 0;
+
+	/* Only the first fetch matches the quirks, the ones during device
+	 * init are cache hits. Fetch them once here for the trace */
+	span = libinput_trace_begin(libinput, device->sysname, "quirks");
+	quirks_unref(libinput_device_get_quirks(&device->base));
+	libinput_trace_end(libinput, span);
+
 	device->scroll.wheel_click_angle = evdev_read_wheel_click_props(device);
 	device->model_flags = evdev_read_model_flags(device);
 	device->dpi = DEFAULT_MOUSE_DPI;
@@ -2347,12 +2369,15 @@ evdev_device_create(struct libinput_seat *seat, struct udev_device *udev_device)
 						 device->evdev,
 						 device->udev_device);
 
+	span = libinput_trace_begin(libinput, device->sysname, "dispatch init");
 	device->dispatch = evdev_configure_device(device, udev_tags);
+	libinput_trace_end(libinput, span);
 	if (device->dispatch == NULL ||
 	    device->seat_caps == EVDEV_DEVICE_NO_CAPABILITIES)
 		goto err_notify;
 
-	device->source = libinput_add_fd(libinput, fd, evdev_device_dispatch, device);
+	device->source =
+		libinput_seat_add_fd(seat, fd, evdev_device_dispatch, device);
 	if (!device->source)
 		goto err_notify;
 
@@ -2360,9 +2385,16 @@ evdev_device_create(struct libinput_seat *seat, struct udev_device *udev_device)
 		goto err_notify;
 
 	list_insert(seat->devices_list.prev, &device->base.link);
+	list_insert(libinput_device_table_bucket(libinput,
+						 udev_device_get_syspath(udev_device)),
+		    &device->table_link);
 
 	device->base.inject_evdev_frame = libinput_device_dispatch_frame;
 
+	evdev_log_debug(device,
+			"device initialized in %.2fms\n",
+			us2ms_f(libinput_now(libinput) - start));
+
 	evdev_notify_added_device(device);
 
 	return device;
@@ -2910,7 +2942,10 @@ evdev_device_resume(struct evdev_device *device)
 					     &ev);
 	} while (status == LIBEVDEV_READ_STATUS_SYNC);
 
-	device->source = libinput_add_fd(libinput, fd, evdev_device_dispatch, device);
+	device->source = libinput_seat_add_fd(device->base.seat,
+					      fd,
+					      evdev_device_dispatch,
+					      device);
 	if (!device->source)
 		return -ENOMEM;
 
@@ -2948,6 +2983,7 @@ evdev_device_remove(struct evdev_device *device)
 	device->was_removed = true;
 
 	list_remove(&device->base.link);
+	list_remove(&device->table_link);
 
 	notify_removed_device(&device->base);
 	libinput_device_unref(&device->base);
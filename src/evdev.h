@@ -172,6 +172,7 @@ struct evdev_device {
 	struct evdev_dispatch *dispatch;
 	struct libevdev *evdev;
 	struct udev_device *udev_device;
+	struct list table_link; /* libinput->device_table, by syspath */
 	char *output_name;
 	const char *devname;
 	char *log_prefix_name;
@@ -251,6 +252,10 @@ struct evdev_device {
 	struct {
 		struct libinput_device_config_accel config;
 		struct motion_filter *filter;
+		/* Non-zero for flat profiles, the factor to apply instead
+		 * of calling the filter. See
+		 * evdev_device_update_accel_constant_factor() */
+		double constant_factor;
 	} pointer;
 
 	/* Key counter used for multiplexing button events internally in
@@ -395,8 +400,16 @@ evdev_device_has_model_quirk(struct evdev_device *device, enum quirk model_quirk
 	return libinput_device_has_model_quirk(&device->base, model_quirk);
 }
 
-void
-evdev_transform_absolute(struct evdev_device *device, struct device_coords *point);
+/* Inline so the common uncalibrated case is a single branch at the
+ * caller, this is called for every touch point and tablet frame */
+static inline void
+evdev_transform_absolute(struct evdev_device *device, struct device_coords *point)
+{
+	if (!device->abs.apply_calibration)
+		return;
+
+	matrix_mult_vec(&device->abs.calibration, &point->x, &point->y);
+}
 
 void
 evdev_transform_relative(struct evdev_device *device, struct device_coords *point);
@@ -421,6 +434,9 @@ void
 evdev_device_init_pointer_acceleration(struct evdev_device *device,
 				       struct motion_filter *filter);
 
+void
+evdev_device_update_accel_constant_factor(struct evdev_device *device);
+
 struct evdev_dispatch *
 evdev_touchpad_create(struct evdev_device *device);
 
@@ -500,6 +516,11 @@ evdev_device_has_switch(struct evdev_device *device, enum libinput_switch sw);
 int
 evdev_device_tablet_pad_has_key(struct evdev_device *device, uint32_t code);
 
+void
+evdev_device_touchpad_palm_stats_dump(struct evdev_device *device,
+				      libinput_palm_stats_func func,
+				      void *user_data);
+
 int
 evdev_device_tablet_pad_get_num_buttons(struct evdev_device *device);
 
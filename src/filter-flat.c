@@ -100,6 +100,15 @@ accelerator_set_speed_flat(struct motion_filter *filter, double speed_adjustment
 	return true;
 }
 
+static double
+accelerator_get_constant_factor_flat(struct motion_filter *filter)
+{
+	struct pointer_accelerator_flat *accel_filter =
+		(struct pointer_accelerator_flat *)filter;
+
+	return accel_filter->factor;
+}
+
 static void
 accelerator_destroy_flat(struct motion_filter *filter)
 {
@@ -117,6 +126,7 @@ static const struct motion_filter_interface accelerator_interface_flat = {
 	.restart = NULL,
 	.destroy = accelerator_destroy_flat,
 	.set_speed = accelerator_set_speed_flat,
+	.get_constant_factor = accelerator_get_constant_factor_flat,
 };
 
 struct motion_filter *
@@ -50,6 +50,7 @@ struct motion_filter_interface {
 	bool (*set_speed)(struct motion_filter *filter, double speed_adjustment);
 	bool (*set_accel_config)(struct motion_filter *filter,
 				 struct libinput_config_accel *accel_config);
+	double (*get_constant_factor)(struct motion_filter *filter);
 };
 
 struct motion_filter {
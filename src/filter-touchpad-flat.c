@@ -99,6 +99,18 @@ accelerator_set_speed_touchpad_flat(struct motion_filter *filter,
 	return true;
 }
 
+static double
+accelerator_get_constant_factor_touchpad_flat(struct motion_filter *filter)
+{
+	struct touchpad_accelerator_flat *accel =
+		(struct touchpad_accelerator_flat *)filter;
+
+	/* Same as accelerator_filter_touchpad_flat() with
+	 * normalize_for_dpi() folded in */
+	return TP_MAGIC_SLOWDOWN_FLAT * accel->factor * DEFAULT_MOUSE_DPI /
+	       accel->dpi;
+}
+
 static void
 accelerator_destroy_touchpad_flat(struct motion_filter *filter)
 {
@@ -116,6 +128,7 @@ static const struct motion_filter_interface accelerator_interface_touchpad_flat
 	.restart = NULL,
 	.destroy = accelerator_destroy_touchpad_flat,
 	.set_speed = accelerator_set_speed_touchpad_flat,
+	.get_constant_factor = accelerator_get_constant_factor_touchpad_flat,
 };
 
 struct motion_filter *
@@ -116,6 +116,15 @@ trackpoint_flat_set_speed(struct motion_filter *filter, double speed_adjustment)
 	return true;
 }
 
+static double
+trackpoint_flat_get_constant_factor(struct motion_filter *filter)
+{
+	struct trackpoint_flat_accelerator *accel_filter =
+		(struct trackpoint_flat_accelerator *)filter;
+
+	return accel_filter->speed_factor * accel_filter->multiplier;
+}
+
 static void
 trackpoint_flat_destroy(struct motion_filter *filter)
 {
@@ -133,6 +142,7 @@ static struct motion_filter_interface accelerator_interface_flat = {
 	.restart = NULL,
 	.destroy = trackpoint_flat_destroy,
 	.set_speed = trackpoint_flat_set_speed,
+	.get_constant_factor = trackpoint_flat_get_constant_factor,
 };
 
 struct motion_filter *
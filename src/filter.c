@@ -98,6 +98,15 @@ filter_get_type(struct motion_filter *filter)
 	return filter->interface->type;
 }
 
+double
+filter_get_constant_factor(struct motion_filter *filter)
+{
+	if (!filter->interface->get_constant_factor)
+		return 0.0;
+
+	return filter->interface->get_constant_factor(filter);
+}
+
 bool
 filter_set_accel_config(struct motion_filter *filter,
 			struct libinput_config_accel *accel_config)
@@ -130,6 +130,21 @@ bool
 filter_set_accel_config(struct motion_filter *filter,
 			struct libinput_config_accel *accel_config);
 
+/**
+ * Return the factor a constant filter applies to every delta, including
+ * any normalization to the default dpi. For such a filter,
+ * filter_dispatch(), filter_dispatch_constant() and
+ * filter_dispatch_scroll() are equivalent to multiplying the
+ * unaccelerated delta with this factor.
+ *
+ * The factor changes with the speed setting, callers caching it must
+ * refresh it after filter_set_speed().
+ *
+ * @return The constant factor or 0.0 if the filter accelerates
+ */
+double
+filter_get_constant_factor(struct motion_filter *filter);
+
 /* Pointer acceleration types */
 struct motion_filter *
 create_pointer_accelerator_filter_flat(int dpi);
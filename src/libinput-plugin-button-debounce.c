@@ -93,7 +93,24 @@ enum debounce_state {
 	DEBOUNCE_STATE_IS_UP_WAITING,
 	DEBOUNCE_STATE_IS_DOWN_DELAYING,
 
-	DEBOUNCE_STATE_DISABLED = 999,
+	DEBOUNCE_STATE_DISABLED,
+};
+
+/* Side effects of a transition, applied in the order listed here */
+enum debounce_action {
+	DEBOUNCE_ACTION_NONE = 0,
+	DEBOUNCE_ACTION_BUG = bit(0),
+	DEBOUNCE_ACTION_SAVE_TIME = bit(1),
+	DEBOUNCE_ACTION_SET_TIMER = bit(2),
+	DEBOUNCE_ACTION_SET_TIMER_SHORT = bit(3),
+	DEBOUNCE_ACTION_CANCEL_TIMER = bit(4),
+	DEBOUNCE_ACTION_CANCEL_TIMER_SHORT = bit(5),
+	/* If spurious debouncing is enabled, move to
+	 * IS_UP_DELAYING_SPURIOUS instead and hold back the release */
+	DEBOUNCE_ACTION_DELAY_IF_SPURIOUS = bit(6),
+	DEBOUNCE_ACTION_ENABLE_SPURIOUS = bit(7),
+	DEBOUNCE_ACTION_NOTIFY_PRESS = bit(8),
+	DEBOUNCE_ACTION_NOTIFY_RELEASE = bit(9),
 };
 
 static inline const char *
@@ -140,6 +157,9 @@ struct plugin_device {
 
 	struct libinput_plugin_timer *timer;
 	struct libinput_plugin_timer *timer_short;
+	/* Currently armed deadlines, 0 if the timer is not set */
+	uint64_t timer_expiry;
+	uint64_t timer_short_expiry;
 };
 
 static void
@@ -205,28 +225,45 @@ static inline void
 debounce_set_timer(struct plugin_device *device, uint64_t time)
 {
 	const int DEBOUNCE_TIMEOUT_BOUNCE = ms2us(25);
+	uint64_t expiry = time + DEBOUNCE_TIMEOUT_BOUNCE;
+
+	if (device->timer_expiry == expiry)
+		return;
 
-	libinput_plugin_timer_set(device->timer, time + DEBOUNCE_TIMEOUT_BOUNCE);
+	device->timer_expiry = expiry;
+	libinput_plugin_timer_set(device->timer, expiry);
 }
 
 static inline void
 debounce_set_timer_short(struct plugin_device *device, uint64_t time)
 {
 	const int DEBOUNCE_TIMEOUT_SPURIOUS = ms2us(12);
+	uint64_t expiry = time + DEBOUNCE_TIMEOUT_SPURIOUS;
 
-	libinput_plugin_timer_set(device->timer_short,
-				  time + DEBOUNCE_TIMEOUT_SPURIOUS);
+	if (device->timer_short_expiry == expiry)
+		return;
+
+	device->timer_short_expiry = expiry;
+	libinput_plugin_timer_set(device->timer_short, expiry);
 }
 
 static inline void
 debounce_cancel_timer(struct plugin_device *device)
 {
+	if (device->timer_expiry == 0)
+		return;
+
+	device->timer_expiry = 0;
 	libinput_plugin_timer_cancel(device->timer);
 }
 
 static inline void
 debounce_cancel_timer_short(struct plugin_device *device)
 {
+	if (device->timer_short_expiry == 0)
+		return;
+
+	device->timer_short_expiry = 0;
 	libinput_plugin_timer_cancel(device->timer_short);
 }
 
@@ -266,276 +303,133 @@ debounce_notify_button(struct plugin_device *device,
 					    frame);
 }
 
-static void
-debounce_is_up_handle_event(struct plugin_device *device,
-			    enum debounce_event event,
-			    struct evdev_frame *frame,
-			    uint64_t time)
-{
-	switch (event) {
-	case DEBOUNCE_EVENT_PRESS:
-		device->button_time = time;
-		debounce_set_timer(device, time);
-		debounce_set_state(device, DEBOUNCE_STATE_IS_DOWN_WAITING);
-		debounce_notify_button(device, frame, LIBINPUT_BUTTON_STATE_PRESSED);
-		break;
-	case DEBOUNCE_EVENT_RELEASE:
-	case DEBOUNCE_EVENT_TIMEOUT:
-	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		break;
-	}
-}
+struct debounce_transition {
+	uint8_t next;     /* enum debounce_state - DEBOUNCE_STATE_IS_UP */
+	uint16_t actions; /* enum debounce_action */
+};
 
-static void
-debounce_is_down_handle_event(struct plugin_device *device,
-			      enum debounce_event event,
-			      struct evdev_frame *frame,
-			      uint64_t time)
-{
-	switch (event) {
-	case DEBOUNCE_EVENT_PRESS:
+#define S_(s_) [DEBOUNCE_STATE_##s_ - DEBOUNCE_STATE_IS_UP]
+#define E_(e_) [DEBOUNCE_EVENT_##e_ - DEBOUNCE_EVENT_PRESS]
+#define T_(s_, a_) \
+	{ .next = DEBOUNCE_STATE_##s_ - DEBOUNCE_STATE_IS_UP, .actions = (a_) }
+#define NONE_ DEBOUNCE_ACTION_NONE
+#define BUG_ DEBOUNCE_ACTION_BUG
+#define TIME_ DEBOUNCE_ACTION_SAVE_TIME
+#define TIMER_ DEBOUNCE_ACTION_SET_TIMER
+#define TIMER_SHORT_ DEBOUNCE_ACTION_SET_TIMER_SHORT
+#define CANCEL_ DEBOUNCE_ACTION_CANCEL_TIMER
+#define CANCEL_SHORT_ DEBOUNCE_ACTION_CANCEL_TIMER_SHORT
+#define PRESS_ DEBOUNCE_ACTION_NOTIFY_PRESS
+#define RELEASE_ DEBOUNCE_ACTION_NOTIFY_RELEASE
+
+/* The full state machine, indexed by [state][event]. Invalid events keep
+ * the current state and log a bug. */
+static const struct debounce_transition debounce_transitions[][5] = {
+	S_(IS_UP) = {
+		E_(PRESS) = T_(IS_DOWN_WAITING, TIME_ | TIMER_ | PRESS_),
+		E_(RELEASE) = T_(IS_UP, BUG_),
+		E_(TIMEOUT) = T_(IS_UP, BUG_),
+		E_(TIMEOUT_SHORT) = T_(IS_UP, BUG_),
+		E_(OTHERBUTTON) = T_(IS_UP, NONE_),
+	},
+	S_(IS_DOWN) = {
 		/* If we lost the kernel button release event (e.g. something
 		 * grabbed the device for a short while) we quietly ignore
 		 * the next down event */
-		break;
-	case DEBOUNCE_EVENT_RELEASE:
-		device->button_time = time;
-		debounce_set_timer(device, time);
-		debounce_set_timer_short(device, time);
-		if (device->spurious_enabled) {
-			debounce_set_state(device,
-					   DEBOUNCE_STATE_IS_UP_DELAYING_SPURIOUS);
-		} else {
-			debounce_set_state(device,
-					   DEBOUNCE_STATE_IS_UP_DETECTING_SPURIOUS);
-			debounce_notify_button(device,
-					       frame,
-					       LIBINPUT_BUTTON_STATE_RELEASED);
-		}
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT:
-	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		break;
-	}
-}
-
-static void
-debounce_is_down_waiting_handle_event(struct plugin_device *device,
-				      enum debounce_event event,
-				      struct evdev_frame *frame,
-				      uint64_t time)
-{
-	switch (event) {
-	case DEBOUNCE_EVENT_PRESS:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_RELEASE:
-		debounce_set_timer(device, time);
-		debounce_set_state(device, DEBOUNCE_STATE_IS_UP_DELAYING);
+		E_(PRESS) = T_(IS_DOWN, NONE_),
+		E_(RELEASE) = T_(IS_UP_DETECTING_SPURIOUS,
+				 TIME_ | TIMER_ | TIMER_SHORT_ | RELEASE_ |
+				 DEBOUNCE_ACTION_DELAY_IF_SPURIOUS),
+		E_(TIMEOUT) = T_(IS_DOWN, BUG_),
+		E_(TIMEOUT_SHORT) = T_(IS_DOWN, BUG_),
+		E_(OTHERBUTTON) = T_(IS_DOWN, NONE_),
+	},
+	S_(IS_DOWN_WAITING) = {
+		E_(PRESS) = T_(IS_DOWN_WAITING, BUG_),
 		/* Note: In the debouncing RPR case, we use the last
 		 * release's time stamp */
-		device->button_time = time;
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_DOWN);
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_DOWN);
-		break;
-	}
-}
-
-static void
-debounce_is_up_delaying_handle_event(struct plugin_device *device,
-				     enum debounce_event event,
-				     struct evdev_frame *frame,
-				     uint64_t time)
-{
-	switch (event) {
-	case DEBOUNCE_EVENT_PRESS:
-		debounce_set_timer(device, time);
-		debounce_set_state(device, DEBOUNCE_STATE_IS_DOWN_WAITING);
-		break;
-	case DEBOUNCE_EVENT_RELEASE:
-	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT:
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_UP);
-		debounce_notify_button(device, frame, LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	}
-}
-
-static void
-debounce_is_up_delaying_spurious_handle_event(struct plugin_device *device,
-					      enum debounce_event event,
-					      struct evdev_frame *frame,
-					      uint64_t time)
-{
-	switch (event) {
-	case DEBOUNCE_EVENT_PRESS:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_DOWN);
-		debounce_cancel_timer(device);
-		debounce_cancel_timer_short(device);
-		break;
-	case DEBOUNCE_EVENT_RELEASE:
-	case DEBOUNCE_EVENT_TIMEOUT:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_UP_WAITING);
-		debounce_notify_button(device, frame, LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_UP);
-		debounce_notify_button(device, frame, LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	}
-}
-
-static void
-debounce_is_up_detecting_spurious_handle_event(struct plugin_device *device,
-					       enum debounce_event event,
-					       struct evdev_frame *frame,
-					       uint64_t time)
-{
-	switch (event) {
-	case DEBOUNCE_EVENT_PRESS:
-		debounce_set_timer(device, time);
-		debounce_set_timer_short(device, time);
+		E_(RELEASE) = T_(IS_UP_DELAYING, TIME_ | TIMER_),
+		E_(TIMEOUT) = T_(IS_DOWN, NONE_),
+		E_(TIMEOUT_SHORT) = T_(IS_DOWN_WAITING, BUG_),
+		E_(OTHERBUTTON) = T_(IS_DOWN, NONE_),
+	},
+	S_(IS_UP_DELAYING) = {
+		E_(PRESS) = T_(IS_DOWN_WAITING, TIMER_),
+		E_(RELEASE) = T_(IS_UP_DELAYING, BUG_),
+		E_(TIMEOUT) = T_(IS_UP, RELEASE_),
+		E_(TIMEOUT_SHORT) = T_(IS_UP_DELAYING, BUG_),
+		E_(OTHERBUTTON) = T_(IS_UP, RELEASE_),
+	},
+	S_(IS_UP_DELAYING_SPURIOUS) = {
+		E_(PRESS) = T_(IS_DOWN, CANCEL_ | CANCEL_SHORT_),
+		E_(RELEASE) = T_(IS_UP_DELAYING_SPURIOUS, BUG_),
+		E_(TIMEOUT) = T_(IS_UP_DELAYING_SPURIOUS, BUG_),
+		E_(TIMEOUT_SHORT) = T_(IS_UP_WAITING, RELEASE_),
+		E_(OTHERBUTTON) = T_(IS_UP, RELEASE_),
+	},
+	S_(IS_UP_DETECTING_SPURIOUS) = {
 		/* Note: in a bouncing PRP case, we use the last press
 		 * event time */
-		device->button_time = time;
-		debounce_set_state(device, DEBOUNCE_STATE_IS_DOWN_DETECTING_SPURIOUS);
-		break;
-	case DEBOUNCE_EVENT_RELEASE:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_UP);
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_UP_WAITING);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_UP);
-		break;
-	}
-}
-
-static void
-debounce_is_down_detecting_spurious_handle_event(struct plugin_device *device,
-						 enum debounce_event event,
-						 struct evdev_frame *frame,
-						 uint64_t time)
-{
-	switch (event) {
-	case DEBOUNCE_EVENT_PRESS:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_RELEASE:
-		debounce_set_timer(device, time);
-		debounce_set_timer_short(device, time);
-		debounce_set_state(device, DEBOUNCE_STATE_IS_UP_DETECTING_SPURIOUS);
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		debounce_cancel_timer(device);
-		debounce_set_state(device, DEBOUNCE_STATE_IS_DOWN);
-		debounce_enable_spurious(device);
-		debounce_notify_button(device, frame, LIBINPUT_BUTTON_STATE_PRESSED);
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT:
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_DOWN);
-		debounce_notify_button(device, frame, LIBINPUT_BUTTON_STATE_PRESSED);
-		break;
-	}
-}
-
-static void
-debounce_is_up_waiting_handle_event(struct plugin_device *device,
-				    enum debounce_event event,
-				    struct evdev_frame *frame,
-				    uint64_t time)
-{
-	switch (event) {
-	case DEBOUNCE_EVENT_PRESS:
-		debounce_set_timer(device, time);
+		E_(PRESS) = T_(IS_DOWN_DETECTING_SPURIOUS,
+			       TIME_ | TIMER_ | TIMER_SHORT_),
+		E_(RELEASE) = T_(IS_UP_DETECTING_SPURIOUS, BUG_),
+		E_(TIMEOUT) = T_(IS_UP, NONE_),
+		E_(TIMEOUT_SHORT) = T_(IS_UP_WAITING, NONE_),
+		E_(OTHERBUTTON) = T_(IS_UP, NONE_),
+	},
+	S_(IS_DOWN_DETECTING_SPURIOUS) = {
+		E_(PRESS) = T_(IS_DOWN_DETECTING_SPURIOUS, BUG_),
+		E_(RELEASE) = T_(IS_UP_DETECTING_SPURIOUS, TIMER_ | TIMER_SHORT_),
+		E_(TIMEOUT) = T_(IS_DOWN, PRESS_),
+		E_(TIMEOUT_SHORT) = T_(IS_DOWN,
+				       CANCEL_ | DEBOUNCE_ACTION_ENABLE_SPURIOUS |
+					       PRESS_),
+		E_(OTHERBUTTON) = T_(IS_DOWN, PRESS_),
+	},
+	S_(IS_UP_WAITING) = {
 		/* Note: in a debouncing PRP case, we use the last press'
 		 * time */
-		device->button_time = time;
-		debounce_set_state(device, DEBOUNCE_STATE_IS_DOWN_DELAYING);
-		break;
-	case DEBOUNCE_EVENT_RELEASE:
-	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT:
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_UP);
-		break;
-	}
-}
-
-static void
-debounce_is_down_delaying_handle_event(struct plugin_device *device,
-				       enum debounce_event event,
-				       struct evdev_frame *frame,
-				       uint64_t time)
-{
-	switch (event) {
-	case DEBOUNCE_EVENT_PRESS:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_RELEASE:
-		debounce_set_timer(device, time);
-		debounce_set_state(device, DEBOUNCE_STATE_IS_UP_WAITING);
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT:
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		debounce_set_state(device, DEBOUNCE_STATE_IS_DOWN);
-		debounce_notify_button(device, frame, LIBINPUT_BUTTON_STATE_PRESSED);
-		break;
-	}
-}
+		E_(PRESS) = T_(IS_DOWN_DELAYING, TIME_ | TIMER_),
+		E_(RELEASE) = T_(IS_UP_WAITING, BUG_),
+		E_(TIMEOUT) = T_(IS_UP, NONE_),
+		E_(TIMEOUT_SHORT) = T_(IS_UP_WAITING, BUG_),
+		E_(OTHERBUTTON) = T_(IS_UP, NONE_),
+	},
+	S_(IS_DOWN_DELAYING) = {
+		E_(PRESS) = T_(IS_DOWN_DELAYING, BUG_),
+		E_(RELEASE) = T_(IS_UP_WAITING, TIMER_),
+		E_(TIMEOUT) = T_(IS_DOWN, PRESS_),
+		E_(TIMEOUT_SHORT) = T_(IS_DOWN_DELAYING, BUG_),
+		E_(OTHERBUTTON) = T_(IS_DOWN, PRESS_),
+	},
+	S_(DISABLED) = {
+		E_(PRESS) = T_(DISABLED, TIME_ | PRESS_),
+		E_(RELEASE) = T_(DISABLED, TIME_ | RELEASE_),
+		E_(TIMEOUT) = T_(DISABLED, BUG_),
+		E_(TIMEOUT_SHORT) = T_(DISABLED, BUG_),
+		E_(OTHERBUTTON) = T_(DISABLED, NONE_),
+	},
+};
 
-static void
-debounce_disabled_handle_event(struct plugin_device *device,
-			       enum debounce_event event,
-			       struct evdev_frame *frame,
-			       uint64_t time)
-{
-	switch (event) {
-	case DEBOUNCE_EVENT_PRESS:
-		device->button_time = time;
-		debounce_notify_button(device, frame, LIBINPUT_BUTTON_STATE_PRESSED);
-		break;
-	case DEBOUNCE_EVENT_RELEASE:
-		device->button_time = time;
-		debounce_notify_button(device, frame, LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case DEBOUNCE_EVENT_TIMEOUT_SHORT:
-	case DEBOUNCE_EVENT_TIMEOUT:
-		log_debounce_bug(device, event);
-		break;
-	case DEBOUNCE_EVENT_OTHERBUTTON:
-		break;
-	}
-}
+#undef S_
+#undef E_
+#undef T_
+#undef NONE_
+#undef BUG_
+#undef TIME_
+#undef TIMER_
+#undef TIMER_SHORT_
+#undef CANCEL_
+#undef CANCEL_SHORT_
+#undef PRESS_
+#undef RELEASE_
+
+static_assert(ARRAY_LENGTH(debounce_transitions) ==
+		      DEBOUNCE_STATE_DISABLED - DEBOUNCE_STATE_IS_UP + 1,
+	      "Missing debounce states in transition table");
+static_assert(ARRAY_LENGTH(debounce_transitions[0]) ==
+		      DEBOUNCE_EVENT_OTHERBUTTON - DEBOUNCE_EVENT_PRESS + 1,
+	      "Missing debounce events in transition table");
 
 static void
 debounce_handle_event(struct plugin_device *device,
@@ -544,54 +438,45 @@ debounce_handle_event(struct plugin_device *device,
 		      uint64_t time)
 {
 	enum debounce_state current = device->state;
+	const struct debounce_transition *t =
+		&debounce_transitions[current - DEBOUNCE_STATE_IS_UP]
+				     [event - DEBOUNCE_EVENT_PRESS];
+	enum debounce_state next = DEBOUNCE_STATE_IS_UP + t->next;
+	uint32_t actions = t->actions;
 
 	if (event == DEBOUNCE_EVENT_OTHERBUTTON) {
 		debounce_cancel_timer(device);
 		debounce_cancel_timer_short(device);
 	}
 
-	switch (current) {
-	case DEBOUNCE_STATE_IS_UP:
-		debounce_is_up_handle_event(device, event, frame, time);
-		break;
-	case DEBOUNCE_STATE_IS_DOWN:
-		debounce_is_down_handle_event(device, event, frame, time);
-		break;
-	case DEBOUNCE_STATE_IS_DOWN_WAITING:
-		debounce_is_down_waiting_handle_event(device, event, frame, time);
-		break;
-	case DEBOUNCE_STATE_IS_UP_DELAYING:
-		debounce_is_up_delaying_handle_event(device, event, frame, time);
-		break;
-	case DEBOUNCE_STATE_IS_UP_DELAYING_SPURIOUS:
-		debounce_is_up_delaying_spurious_handle_event(device,
-							      event,
-							      frame,
-							      time);
-		break;
-	case DEBOUNCE_STATE_IS_UP_DETECTING_SPURIOUS:
-		debounce_is_up_detecting_spurious_handle_event(device,
-							       event,
-							       frame,
-							       time);
-		break;
-	case DEBOUNCE_STATE_IS_DOWN_DETECTING_SPURIOUS:
-		debounce_is_down_detecting_spurious_handle_event(device,
-								 event,
-								 frame,
-								 time);
-		break;
-	case DEBOUNCE_STATE_IS_UP_WAITING:
-		debounce_is_up_waiting_handle_event(device, event, frame, time);
-		break;
-	case DEBOUNCE_STATE_IS_DOWN_DELAYING:
-		debounce_is_down_delaying_handle_event(device, event, frame, time);
-		break;
-	case DEBOUNCE_STATE_DISABLED:
-		debounce_disabled_handle_event(device, event, frame, time);
-		break;
+	if ((actions & DEBOUNCE_ACTION_DELAY_IF_SPURIOUS) &&
+	    device->spurious_enabled) {
+		next = DEBOUNCE_STATE_IS_UP_DELAYING_SPURIOUS;
+		actions &= ~DEBOUNCE_ACTION_NOTIFY_RELEASE;
 	}
 
+	if (actions & DEBOUNCE_ACTION_BUG)
+		log_debounce_bug(device, event);
+	if (actions & DEBOUNCE_ACTION_SAVE_TIME)
+		device->button_time = time;
+	if (actions & DEBOUNCE_ACTION_SET_TIMER)
+		debounce_set_timer(device, time);
+	if (actions & DEBOUNCE_ACTION_SET_TIMER_SHORT)
+		debounce_set_timer_short(device, time);
+	if (actions & DEBOUNCE_ACTION_CANCEL_TIMER)
+		debounce_cancel_timer(device);
+	if (actions & DEBOUNCE_ACTION_CANCEL_TIMER_SHORT)
+		debounce_cancel_timer_short(device);
+
+	device->state = next;
+
+	if (actions & DEBOUNCE_ACTION_ENABLE_SPURIOUS)
+		debounce_enable_spurious(device);
+	if (actions & DEBOUNCE_ACTION_NOTIFY_PRESS)
+		debounce_notify_button(device, frame, LIBINPUT_BUTTON_STATE_PRESSED);
+	if (actions & DEBOUNCE_ACTION_NOTIFY_RELEASE)
+		debounce_notify_button(device, frame, LIBINPUT_BUTTON_STATE_RELEASED);
+
 	plugin_log_debug(device->parent->plugin,
 			 "debounce state: %s → %s → %s\n",
 			 debounce_state_to_str(current),
@@ -707,6 +592,7 @@ debounce_timeout(struct libinput_plugin *plugin, uint64_t now, void *data)
 {
 	struct plugin_device *device = data;
 
+	device->timer_expiry = 0;
 	debounce_handle_event(device, DEBOUNCE_EVENT_TIMEOUT, NULL, now);
 }
 
@@ -715,6 +601,7 @@ debounce_timeout_short(struct libinput_plugin *plugin, uint64_t now, void *data)
 {
 	struct plugin_device *device = data;
 
+	device->timer_short_expiry = 0;
 	debounce_handle_event(device, DEBOUNCE_EVENT_TIMEOUT_SHORT, NULL, now);
 }
 
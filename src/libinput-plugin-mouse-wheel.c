@@ -78,6 +78,8 @@ struct plugin_device {
 	struct device_coords hi_res;
 	bool hi_res_event_received;
 	struct libinput_plugin_timer *scroll_timer;
+	bool scroll_timer_armed;
+	uint64_t scroll_timer_expiry;
 	enum wheel_direction dir;
 	enum ignore_strategy ignore_small_hi_res_movements;
 	int min_movement;
@@ -128,7 +130,17 @@ wheel_set_scroll_timer(struct plugin_device *pd, uint64_t time)
 	if (!pd->scroll_timer)
 		return;
 
-	libinput_plugin_timer_set(pd->scroll_timer, time + WHEEL_SCROLL_TIMEOUT);
+	/* A free-spinning wheel sends events at the device's report rate,
+	 * re-arming the timer for each of those is expensive. If the timer
+	 * is already running we only push the deadline out and the
+	 * timeout handler re-arms the timer for the new deadline.
+	 */
+	pd->scroll_timer_expiry = time + WHEEL_SCROLL_TIMEOUT;
+	if (pd->scroll_timer_armed)
+		return;
+
+	pd->scroll_timer_armed = true;
+	libinput_plugin_timer_set(pd->scroll_timer, pd->scroll_timer_expiry);
 }
 
 static inline void
@@ -137,6 +149,7 @@ wheel_cancel_scroll_timer(struct plugin_device *pd)
 	if (!pd->scroll_timer)
 		return;
 
+	pd->scroll_timer_armed = false;
 	libinput_plugin_timer_cancel(pd->scroll_timer);
 }
 
@@ -241,12 +254,11 @@ static void
 wheel_remove_scroll_events(struct evdev_frame *frame)
 {
 	size_t nevents;
-	_unref_(evdev_frame) *copy = evdev_frame_clone(frame);
-	struct evdev_event *events = evdev_frame_get_events(copy, &nevents);
-
-	evdev_frame_reset(frame);
+	size_t nkept = 0;
+	struct evdev_event *events = evdev_frame_get_events(frame, &nevents);
 
-	for (size_t i = 0; i < nevents; i++) {
+	/* nevents - 1 because we don't check the SYN_REPORT */
+	for (size_t i = 0; i < nevents - 1; i++) {
 		struct evdev_event *e = &events[i];
 
 		switch (evdev_usage_enum(e->usage)) {
@@ -254,13 +266,15 @@ wheel_remove_scroll_events(struct evdev_frame *frame)
 		case EVDEV_REL_WHEEL_HI_RES:
 		case EVDEV_REL_HWHEEL:
 		case EVDEV_REL_HWHEEL_HI_RES:
-			/* Do not append scroll events */
+			/* Drop scroll events */
 			break;
 		default:
-			evdev_frame_append(frame, e, 1);
+			events[nkept++] = *e;
 			break;
 		}
 	}
+
+	evdev_frame_truncate(frame, nkept);
 }
 
 static void
@@ -429,6 +443,17 @@ wheel_on_scroll_timer_timeout(struct libinput_plugin *plugin, uint64_t now, void
 {
 	struct plugin_device *pd = data;
 
+	pd->scroll_timer_armed = false;
+
+	/* Scroll events arrived after the timer was armed, see
+	 * wheel_set_scroll_timer() */
+	if (now < pd->scroll_timer_expiry) {
+		pd->scroll_timer_armed = true;
+		libinput_plugin_timer_set(pd->scroll_timer,
+					  pd->scroll_timer_expiry);
+		return;
+	}
+
 	wheel_handle_event(pd, WHEEL_EVENT_SCROLL_TIMEOUT, now);
 }
 
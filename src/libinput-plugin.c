@@ -300,16 +300,28 @@ libinput_plugin_notify_device_new(struct libinput_plugin *plugin,
 				  struct libevdev *evdev,
 				  struct udev_device *udev_device)
 {
-	if (plugin->interface->device_new)
+	if (plugin->interface->device_new) {
+		size_t span = libinput_trace_begin(plugin->libinput,
+						   libinput_device_get_sysname(device),
+						   "plugin %s: device new",
+						   plugin->name);
 		plugin->interface->device_new(plugin, device, evdev, udev_device);
+		libinput_trace_end(plugin->libinput, span);
+	}
 }
 
 void
 libinput_plugin_notify_device_added(struct libinput_plugin *plugin,
 				    struct libinput_device *device)
 {
-	if (plugin->interface->device_added)
+	if (plugin->interface->device_added) {
+		size_t span = libinput_trace_begin(plugin->libinput,
+						   libinput_device_get_sysname(device),
+						   "plugin %s: device added",
+						   plugin->name);
 		plugin->interface->device_added(plugin, device);
+		libinput_trace_end(plugin->libinput, span);
+	}
 }
 
 void
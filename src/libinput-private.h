@@ -187,6 +187,36 @@ struct libinput_interface_backend {
 				  const char *seat_name);
 };
 
+/* 64 buckets: with a few hundred serial-numbered tools a proximity in
+ * walks a chain of ~5 tools, once per proximity in rather than per
+ * event. The tool_table_stats debug log shows the actual chain lengths */
+#define LIBINPUT_TOOL_TABLE_BITS 6
+#define LIBINPUT_DEVICE_TABLE_BITS 6
+#define LIBINPUT_TRACE_MAX_SPANS 1024
+
+/**
+ * One phase of adding a device, see libinput_trace_begin() and
+ * libinput_trace_dump().
+ */
+struct libinput_trace_span {
+	char device[16];
+	char phase[44];
+	unsigned int depth;
+	uint64_t start;
+	uint64_t end; /* 0 while the span is open */
+};
+
+/**
+ * A ring buffer of events, grown on demand
+ */
+struct libinput_event_queue {
+	struct libinput_event **events;
+	size_t count;
+	size_t len;
+	size_t in;
+	size_t out;
+};
+
 struct libinput {
 	int epoll_fd;
 	struct list source_destroy_list;
@@ -202,13 +232,20 @@ struct libinput {
 		struct ratelimit expiry_in_past_limit;
 	} timer;
 
-	struct libinput_event **events;
-	size_t events_count;
-	size_t events_len;
-	size_t events_in;
-	size_t events_out;
+	struct libinput_event_queue events;
 
 	struct list tool_list;
+	/* Tools with a serial number, hashed by type and serial for a
+	 * quick lookup on proximity in. These tools are in tool_list too. */
+	struct list tool_table[1 << LIBINPUT_TOOL_TABLE_BITS];
+	struct {
+		uint64_t lookups;
+		uint64_t collisions; /* tools skipped in a bucket during a lookup */
+	} tool_table_stats;
+
+	/* Devices hashed by syspath, for a lookup on udev add and remove
+	 * that doesn't walk every seat. See evdev_device->table_link */
+	struct list device_table[1 << LIBINPUT_DEVICE_TABLE_BITS];
 
 	const struct libinput_interface *interface;
 	const struct libinput_interface_backend *interface_backend;
@@ -234,6 +271,14 @@ struct libinput {
 		size_t refcount;
 	} libwacom;
 #endif
+
+	struct {
+		/* Ring buffer, allocated on the first span. Span n is in
+		 * spans[n % LIBINPUT_TRACE_MAX_SPANS] */
+		struct libinput_trace_span *spans;
+		size_t nspans; /* total number of spans started */
+		unsigned int depth;
+	} trace;
 };
 
 typedef void (*libinput_seat_destroy_func)(struct libinput_seat *seat);
@@ -252,6 +297,12 @@ struct libinput_seat {
 	uint32_t slot_map;
 
 	uint32_t button_count[KEY_CNT];
+
+	/* -1 until the caller asks for libinput_seat_get_fd(). From then
+	 * on the seat's devices are dispatched from this fd and their
+	 * events are queued here instead of on the context */
+	int epoll_fd;
+	struct libinput_event_queue events;
 };
 
 struct libinput_device_config_tap {
@@ -315,6 +366,17 @@ struct libinput_device_config_area {
 		struct libinput_device *device);
 };
 
+struct libinput_device_config_axis_coalescing {
+	int (*is_available)(struct libinput_device *device);
+	enum libinput_config_status (*set_enabled)(
+		struct libinput_device *device,
+		enum libinput_config_axis_coalescing_state enable);
+	enum libinput_config_axis_coalescing_state (*get_enabled)(
+		struct libinput_device *device);
+	enum libinput_config_axis_coalescing_state (*get_default_enabled)(
+		struct libinput_device *device);
+};
+
 struct libinput_device_config_send_events {
 	uint32_t (*get_modes)(struct libinput_device *device);
 	enum libinput_config_status (*set_mode)(
@@ -508,6 +570,7 @@ struct libinput_device_config {
 	struct libinput_device_config_rotation *rotation;
 	struct libinput_device_config_gesture *gesture;
 	struct libinput_device_config_3fg_drag *drag_3fg;
+	struct libinput_device_config_axis_coalescing *axis_coalescing;
 };
 
 struct libinput_device_group {
@@ -613,6 +676,7 @@ struct libinput_tablet_tool_pressure_threshold {
 
 struct libinput_tablet_tool {
 	struct list link;
+	struct list table_link; /* libinput->tool_table if serial != 0 */
 	uint32_t serial;
 	uint32_t tool_id;
 	enum libinput_tablet_tool_type type;
@@ -649,6 +713,30 @@ struct libinput_tablet_tool {
 	unsigned int last_tablet_id; /* tablet_dispatch->tablet_id */
 };
 
+static inline struct list *
+libinput_tool_table_bucket(struct libinput *libinput,
+			   enum libinput_tablet_tool_type type,
+			   uint32_t serial)
+{
+	/* Serials are often sequential, multiplicative hashing spreads
+	 * them across the table */
+	uint32_t hash = (serial ^ ((uint32_t)type << 24)) * 2654435761u;
+
+	return &libinput->tool_table[hash >> (32 - LIBINPUT_TOOL_TABLE_BITS)];
+}
+
+static inline struct list *
+libinput_device_table_bucket(struct libinput *libinput, const char *syspath)
+{
+	/* FNV-1a, the syspaths only differ in their last few characters */
+	uint32_t hash = 2166136261u;
+
+	for (const char *c = syspath; *c; c++)
+		hash = (hash ^ (uint8_t)*c) * 16777619u;
+
+	return &libinput->device_table[hash >> (32 - LIBINPUT_DEVICE_TABLE_BITS)];
+}
+
 struct libinput_tablet_pad_mode_group {
 	struct libinput_device *device;
 	struct list link;
@@ -699,9 +787,34 @@ libinput_add_fd(struct libinput *libinput,
 		libinput_source_dispatch_t dispatch,
 		void *data);
 
+/**
+ * Like libinput_add_fd() but the fd is dispatched with the seat's
+ * devices, see libinput_seat_get_fd().
+ */
+struct libinput_source *
+libinput_seat_add_fd(struct libinput_seat *seat,
+		     int fd,
+		     libinput_source_dispatch_t dispatch,
+		     void *data);
+
 void
 libinput_remove_source(struct libinput *libinput, struct libinput_source *source);
 
+/**
+ * Start a trace span for the given device (or subsystem) and phase.
+ * Spans started before this one ends are nested inside it.
+ *
+ * @return a handle to pass to libinput_trace_end()
+ */
+size_t
+libinput_trace_begin(struct libinput *libinput,
+		     const char *device,
+		     const char *phase_format,
+		     ...) LIBINPUT_ATTRIBUTE_PRINTF(3, 4);
+
+void
+libinput_trace_end(struct libinput *libinput, size_t span);
+
 int
 open_restricted(struct libinput *libinput, const char *path, int flags);
 
@@ -80,6 +80,7 @@ ASSERT_INT_SIZE(enum libinput_config_middle_emulation_state);
 ASSERT_INT_SIZE(enum libinput_config_scroll_method);
 ASSERT_INT_SIZE(enum libinput_config_dwt_state);
 ASSERT_INT_SIZE(enum libinput_config_dwtp_state);
+ASSERT_INT_SIZE(enum libinput_config_axis_coalescing_state);
 
 static inline const char *
 event_type_to_str(enum libinput_event_type type)
@@ -164,6 +165,7 @@ struct libinput_source {
 	libinput_source_dispatch_t dispatch;
 	void *user_data;
 	int fd;
+	int epoll_fd; /* the context's or the seat's */
 	struct list link;
 };
 
@@ -228,6 +230,15 @@ struct libinput_event_tablet_tool {
 		struct input_absinfo x;
 		struct input_absinfo y;
 	} abs;
+
+	/* Only set if axis events were coalesced, see
+	 * tablet_tool_coalesce_axis_event() */
+	struct tablet_tool_sample {
+		uint64_t time;
+		struct tablet_axes axes;
+	} *samples;
+	size_t nsamples;
+	size_t samples_size;
 };
 
 struct libinput_event_tablet_pad {
@@ -368,6 +379,89 @@ libinput_log_set_handler(struct libinput *libinput, libinput_log_handler log_han
 	libinput->log_handler = log_handler;
 }
 
+static struct libinput_trace_span *
+libinput_trace_new_span(struct libinput *libinput, const char *device)
+{
+	if (!libinput->trace.spans)
+		libinput->trace.spans =
+			zalloc(LIBINPUT_TRACE_MAX_SPANS * sizeof(*libinput->trace.spans));
+
+	size_t idx = libinput->trace.nspans++ % LIBINPUT_TRACE_MAX_SPANS;
+	struct libinput_trace_span *span = &libinput->trace.spans[idx];
+
+	snprintf(span->device, sizeof(span->device), "%s", device);
+	span->depth = libinput->trace.depth;
+	span->start = 0;
+	span->end = 0;
+
+	return span;
+}
+
+size_t
+libinput_trace_begin(struct libinput *libinput,
+		     const char *device,
+		     const char *phase_format,
+		     ...)
+{
+	struct libinput_trace_span *span = libinput_trace_new_span(libinput, device);
+	va_list args;
+
+	va_start(args, phase_format);
+	vsnprintf(span->phase, sizeof(span->phase), phase_format, args);
+	va_end(args);
+
+	libinput->trace.depth++;
+	span->start = libinput_now(libinput);
+
+	return libinput->trace.nspans - 1;
+}
+
+void
+libinput_trace_end(struct libinput *libinput, size_t span)
+{
+	uint64_t now = libinput_now(libinput);
+
+	assert(libinput->trace.depth > 0);
+	libinput->trace.depth--;
+
+	/* Overwritten by newer spans already */
+	if (libinput->trace.nspans - span > LIBINPUT_TRACE_MAX_SPANS)
+		return;
+
+	libinput->trace.spans[span % LIBINPUT_TRACE_MAX_SPANS].end = now;
+}
+
+LIBINPUT_EXPORT void
+libinput_trace_dump(struct libinput *libinput,
+		    libinput_trace_func func,
+		    void *user_data)
+{
+	size_t first = 0;
+
+	if (!libinput->trace.spans)
+		return;
+
+	if (libinput->trace.nspans > LIBINPUT_TRACE_MAX_SPANS)
+		first = libinput->trace.nspans - LIBINPUT_TRACE_MAX_SPANS;
+
+	for (size_t i = first; i < libinput->trace.nspans; i++) {
+		const struct libinput_trace_span *span =
+			&libinput->trace.spans[i % LIBINPUT_TRACE_MAX_SPANS];
+
+		/* Still open */
+		if (span->end == 0)
+			continue;
+
+		func(libinput,
+		     span->device,
+		     span->phase,
+		     span->depth,
+		     span->start,
+		     span->end,
+		     user_data);
+	}
+}
+
 static void
 libinput_device_group_destroy(struct libinput_device_group *group);
 
@@ -1596,6 +1690,113 @@ libinput_event_tablet_tool_get_time_usec(struct libinput_event_tablet_tool *even
 	return event->time;
 }
 
+LIBINPUT_EXPORT unsigned int
+libinput_event_tablet_tool_get_sample_count(struct libinput_event_tablet_tool *event)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
+			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
+			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+
+	return event->nsamples ? event->nsamples : 1;
+}
+
+static inline const struct tablet_axes *
+tablet_tool_event_get_sample(struct libinput_event_tablet_tool *event,
+			     unsigned int sample,
+			     uint64_t *time)
+{
+	static const struct tablet_axes zero;
+
+	if (sample >= libinput_event_tablet_tool_get_sample_count(event)) {
+		log_bug_client(libinput_event_get_context(&event->base),
+			       "invalid sample index %u\n",
+			       sample);
+		*time = 0;
+		return &zero;
+	}
+
+	if (event->nsamples == 0) {
+		*time = event->time;
+		return &event->axes;
+	}
+
+	*time = event->samples[sample].time;
+	return &event->samples[sample].axes;
+}
+
+LIBINPUT_EXPORT uint64_t
+libinput_event_tablet_tool_get_sample_time_usec(struct libinput_event_tablet_tool *event,
+						unsigned int sample)
+{
+	uint64_t time;
+
+	tablet_tool_event_get_sample(event, sample, &time);
+
+	return time;
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_sample_x(struct libinput_event_tablet_tool *event,
+					unsigned int sample)
+{
+	uint64_t time;
+	const struct tablet_axes *axes =
+		tablet_tool_event_get_sample(event, sample, &time);
+
+	return absinfo_convert_to_mm(&event->abs.x, axes->point.x);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_sample_y(struct libinput_event_tablet_tool *event,
+					unsigned int sample)
+{
+	uint64_t time;
+	const struct tablet_axes *axes =
+		tablet_tool_event_get_sample(event, sample, &time);
+
+	return absinfo_convert_to_mm(&event->abs.y, axes->point.y);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_sample_pressure(struct libinput_event_tablet_tool *event,
+					       unsigned int sample)
+{
+	uint64_t time;
+
+	return tablet_tool_event_get_sample(event, sample, &time)->pressure;
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_sample_distance(struct libinput_event_tablet_tool *event,
+					       unsigned int sample)
+{
+	uint64_t time;
+
+	return tablet_tool_event_get_sample(event, sample, &time)->distance;
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_sample_tilt_x(struct libinput_event_tablet_tool *event,
+					     unsigned int sample)
+{
+	uint64_t time;
+
+	return tablet_tool_event_get_sample(event, sample, &time)->tilt.x;
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_sample_tilt_y(struct libinput_event_tablet_tool *event,
+					     unsigned int sample)
+{
+	uint64_t time;
+
+	return tablet_tool_event_get_sample(event, sample, &time)->tilt.y;
+}
+
 LIBINPUT_EXPORT uint32_t
 libinput_event_tablet_tool_get_button(struct libinput_event_tablet_tool *event)
 {
@@ -1734,6 +1935,7 @@ libinput_tablet_tool_unref(struct libinput_tablet_tool *tool)
 		return tool;
 
 	list_remove(&tool->link);
+	list_remove(&tool->table_link);
 	if (tool->last_device)
 		tool->last_device = libinput_device_unref(tool->last_device);
 	free(tool);
@@ -1795,25 +1997,37 @@ libinput_event_switch_get_time_usec(struct libinput_event_switch *event)
 	return event->time;
 }
 
-struct libinput_source *
-libinput_add_fd(struct libinput *libinput,
-		int fd,
-		libinput_source_dispatch_t dispatch,
-		void *user_data)
+static int
+libinput_source_add_to_epoll(struct libinput_source *source, int epoll_fd)
 {
-	struct libinput_source *source;
 	struct epoll_event ep;
 
+	memset(&ep, 0, sizeof ep);
+	ep.events = EPOLLIN;
+	ep.data.ptr = source;
+
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, source->fd, &ep) < 0)
+		return -errno;
+
+	source->epoll_fd = epoll_fd;
+
+	return 0;
+}
+
+static struct libinput_source *
+libinput_add_fd_to_epoll(int epoll_fd,
+			 int fd,
+			 libinput_source_dispatch_t dispatch,
+			 void *user_data)
+{
+	struct libinput_source *source;
+
 	source = zalloc(sizeof *source);
 	source->dispatch = dispatch;
 	source->user_data = user_data;
 	source->fd = fd;
 
-	memset(&ep, 0, sizeof ep);
-	ep.events = EPOLLIN;
-	ep.data.ptr = source;
-
-	if (epoll_ctl(libinput->epoll_fd, EPOLL_CTL_ADD, fd, &ep) < 0) {
+	if (libinput_source_add_to_epoll(source, epoll_fd) < 0) {
 		free(source);
 		return NULL;
 	}
@@ -1821,14 +2035,135 @@ libinput_add_fd(struct libinput *libinput,
 	return source;
 }
 
+struct libinput_source *
+libinput_add_fd(struct libinput *libinput,
+		int fd,
+		libinput_source_dispatch_t dispatch,
+		void *user_data)
+{
+	return libinput_add_fd_to_epoll(libinput->epoll_fd, fd, dispatch, user_data);
+}
+
+struct libinput_source *
+libinput_seat_add_fd(struct libinput_seat *seat,
+		     int fd,
+		     libinput_source_dispatch_t dispatch,
+		     void *user_data)
+{
+	int epoll_fd = seat->epoll_fd;
+
+	if (epoll_fd == -1)
+		epoll_fd = seat->libinput->epoll_fd;
+
+	return libinput_add_fd_to_epoll(epoll_fd, fd, dispatch, user_data);
+}
+
 void
 libinput_remove_source(struct libinput *libinput, struct libinput_source *source)
 {
-	epoll_ctl(libinput->epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
+	epoll_ctl(source->epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
 	source->fd = -1;
 	list_insert(&libinput->source_destroy_list, &source->link);
 }
 
+static void
+libinput_event_queue_init(struct libinput_event_queue *queue)
+{
+	queue->len = 4;
+	queue->events = zalloc(queue->len * sizeof(*queue->events));
+}
+
+static void
+libinput_event_queue_destroy(struct libinput_event_queue *queue)
+{
+	assert(queue->count == 0);
+	free(queue->events);
+	queue->events = NULL;
+}
+
+static void
+libinput_event_queue_push(struct libinput *libinput,
+			  struct libinput_event_queue *queue,
+			  struct libinput_event *event)
+{
+	struct libinput_event **events = queue->events;
+	size_t events_len = queue->len;
+	size_t events_count = queue->count;
+	size_t move_len;
+	size_t new_out;
+
+	events_count++;
+	if (events_count > events_len) {
+		void *tmp;
+
+		events_len *= 2;
+		tmp = realloc(events, events_len * sizeof *events);
+		if (!tmp) {
+			log_error(libinput,
+				  "Failed to reallocate event ring buffer. "
+				  "Events may be discarded\n");
+			return;
+		}
+
+		events = tmp;
+
+		if (queue->count > 0 && queue->in == 0) {
+			queue->in = queue->len;
+		} else if (queue->count > 0 && queue->out >= queue->in) {
+			move_len = queue->len - queue->out;
+			new_out = events_len - move_len;
+			memmove(events + new_out,
+				events + queue->out,
+				move_len * sizeof *events);
+			queue->out = new_out;
+		}
+
+		queue->events = events;
+		queue->len = events_len;
+	}
+
+	if (event->device)
+		libinput_device_ref(event->device);
+
+	queue->count = events_count;
+	events[queue->in] = event;
+	queue->in = (queue->in + 1) % queue->len;
+}
+
+static struct libinput_event *
+libinput_event_queue_pop(struct libinput_event_queue *queue)
+{
+	struct libinput_event *event;
+
+	if (queue->count == 0)
+		return NULL;
+
+	event = queue->events[queue->out];
+	queue->out = (queue->out + 1) % queue->len;
+	queue->count--;
+
+	return event;
+}
+
+static struct libinput_event *
+libinput_event_queue_tail(struct libinput_event_queue *queue)
+{
+	if (queue->count == 0)
+		return NULL;
+
+	return queue->events[(queue->in + queue->len - 1) % queue->len];
+}
+
+static struct libinput_event_queue *
+libinput_event_queue_for_device(struct libinput *libinput,
+				struct libinput_device *device)
+{
+	if (device && device->seat->epoll_fd != -1)
+		return &device->seat->events;
+
+	return &libinput->events;
+}
+
 int
 libinput_init(struct libinput *libinput,
 	      const struct libinput_interface *interface,
@@ -1842,8 +2177,7 @@ libinput_init(struct libinput *libinput,
 	if (libinput->epoll_fd < 0)
 		return -1;
 
-	libinput->events_len = 4;
-	libinput->events = zalloc(libinput->events_len * sizeof(*libinput->events));
+	libinput_event_queue_init(&libinput->events);
 	libinput->log_handler = libinput_default_log_func;
 	libinput->log_priority = LIBINPUT_LOG_PRIORITY_ERROR;
 	libinput->interface = interface;
@@ -1854,11 +2188,15 @@ libinput_init(struct libinput *libinput,
 	list_init(&libinput->seat_list);
 	list_init(&libinput->device_group_list);
 	list_init(&libinput->tool_list);
+	ARRAY_FOR_EACH(libinput->tool_table, bucket)
+		list_init(bucket);
+	ARRAY_FOR_EACH(libinput->device_table, bucket)
+		list_init(bucket);
 
 	libinput_plugin_system_init(&libinput->plugin_system);
 
 	if (libinput_timer_subsys_init(libinput) != 0) {
-		free(libinput->events);
+		libinput_event_queue_destroy(&libinput->events);
 		close(libinput->epoll_fd);
 		return -1;
 	}
@@ -1951,7 +2289,16 @@ libinput_unref(struct libinput *libinput)
 	while ((event = libinput_get_event(libinput)))
 		libinput_event_destroy(event);
 
-	free(libinput->events);
+	/* The last event may hold the last ref to a seat's device and
+	 * thus the seat */
+	list_for_each_safe(seat, &libinput->seat_list, link) {
+		libinput_seat_ref(seat);
+		while ((event = libinput_seat_get_event(seat)))
+			libinput_event_destroy(event);
+		libinput_seat_unref(seat);
+	}
+
+	libinput_event_queue_destroy(&libinput->events);
 
 	list_for_each_safe(tool, &libinput->tool_list, link) {
 		libinput_tablet_tool_unref(tool);
@@ -1974,6 +2321,7 @@ libinput_unref(struct libinput *libinput)
 	libinput_drop_destroyed_sources(libinput);
 	quirks_context_unref(libinput->quirks);
 	close(libinput->epoll_fd);
+	free(libinput->trace.spans);
 	free(libinput);
 
 	return NULL;
@@ -1993,6 +2341,7 @@ static void
 libinput_event_tablet_tool_destroy(struct libinput_event_tablet_tool *event)
 {
 	libinput_tablet_tool_unref(event->tool);
+	free(event->samples);
 }
 
 static void
@@ -2068,6 +2417,7 @@ libinput_seat_init(struct libinput_seat *seat,
 	seat->physical_name = safe_strdup(physical_name);
 	seat->logical_name = safe_strdup(logical_name);
 	seat->destroy = destroy;
+	seat->epoll_fd = -1;
 	list_init(&seat->devices_list);
 	list_insert(&libinput->seat_list, &seat->link);
 }
@@ -2083,6 +2433,10 @@ static void
 libinput_seat_destroy(struct libinput_seat *seat)
 {
 	list_remove(&seat->link);
+	if (seat->epoll_fd != -1) {
+		libinput_event_queue_destroy(&seat->events);
+		close(seat->epoll_fd);
+	}
 	free(seat->logical_name);
 	free(seat->physical_name);
 	seat->destroy(seat);
@@ -2172,8 +2526,8 @@ libinput_get_fd(struct libinput *libinput)
 	return libinput->epoll_fd;
 }
 
-LIBINPUT_EXPORT int
-libinput_dispatch(struct libinput *libinput)
+static int
+libinput_dispatch_epoll(struct libinput *libinput, int epoll_fd)
 {
 	static uint8_t take_time_snapshot;
 	struct libinput_source *source;
@@ -2188,7 +2542,7 @@ libinput_dispatch(struct libinput *libinput)
 	else if (libinput->dispatch_time)
 		libinput->dispatch_time = 0;
 
-	count = epoll_wait(libinput->epoll_fd, ep, ARRAY_LENGTH(ep), 0);
+	count = epoll_wait(epoll_fd, ep, ARRAY_LENGTH(ep), 0);
 	if (count < 0)
 		return -errno;
 
@@ -2205,6 +2559,68 @@ libinput_dispatch(struct libinput *libinput)
 	return 0;
 }
 
+LIBINPUT_EXPORT int
+libinput_dispatch(struct libinput *libinput)
+{
+	return libinput_dispatch_epoll(libinput, libinput->epoll_fd);
+}
+
+LIBINPUT_EXPORT int
+libinput_seat_get_fd(struct libinput_seat *seat)
+{
+	struct libinput_device *device;
+	int epoll_fd;
+
+	if (seat->epoll_fd != -1)
+		return seat->epoll_fd;
+
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd < 0)
+		return -errno;
+
+	/* Move the sources of the existing devices over, new and resumed
+	 * devices use libinput_seat_add_fd() */
+	list_for_each(device, &seat->devices_list, link) {
+		struct libinput_source *source = evdev_device(device)->source;
+		int old_fd;
+
+		if (!source)
+			continue;
+
+		old_fd = source->epoll_fd;
+		if (libinput_source_add_to_epoll(source, epoll_fd) < 0) {
+			log_error(seat->libinput,
+				  "%s: failed to move device to the seat's fd\n",
+				  libinput_device_get_sysname(device));
+			continue;
+		}
+		epoll_ctl(old_fd, EPOLL_CTL_DEL, source->fd, NULL);
+	}
+
+	libinput_event_queue_init(&seat->events);
+	seat->epoll_fd = epoll_fd;
+
+	/* The seat would otherwise be destroyed with its last device,
+	 * closing the fd the caller polls. This ref is dropped with the
+	 * context, libinput_unref() destroys all seats */
+	libinput_seat_ref(seat);
+
+	return epoll_fd;
+}
+
+LIBINPUT_EXPORT int
+libinput_seat_dispatch(struct libinput_seat *seat)
+{
+	if (seat->epoll_fd == -1) {
+		log_bug_client(seat->libinput,
+			       "libinput_seat_get_fd() was never called for "
+			       "this seat\n");
+		return -EINVAL;
+	}
+
+	return libinput_dispatch_epoll(seat->libinput, seat->epoll_fd);
+}
+
 void
 libinput_device_init_event_listener(struct libinput_event_listener *listener)
 {
@@ -2308,6 +2724,95 @@ post_base_event(struct libinput_device *device,
 	libinput_post_event(libinput, event);
 }
 
+/* Max samples in a coalesced axis event, ~300ms at 200Hz */
+#define TABLET_TOOL_MAX_SAMPLES 64
+
+static bool
+tablet_tool_event_add_sample(struct libinput_event_tablet_tool *event,
+			     uint64_t time,
+			     const struct tablet_axes *axes)
+{
+	if (event->nsamples == event->samples_size) {
+		size_t size = max(event->samples_size * 2, 8U);
+		struct tablet_tool_sample *samples;
+
+		samples = realloc(event->samples, size * sizeof(*samples));
+		if (!samples)
+			return false;
+
+		event->samples = samples;
+		event->samples_size = size;
+	}
+
+	event->samples[event->nsamples++] = (struct tablet_tool_sample){
+		.time = time,
+		.axes = *axes,
+	};
+
+	return true;
+}
+
+/**
+ * If axis coalescing is enabled and the most recently queued event is a
+ * not-yet-retrieved axis event for the same tool, merge the new axis
+ * event into that one and free the new event.
+ *
+ * @return true if the event was coalesced, false if it needs to be queued
+ */
+static bool
+tablet_tool_coalesce_axis_event(struct libinput_device *device,
+				struct libinput_event *event)
+{
+	struct libinput *libinput = device->seat->libinput;
+	struct libinput_event_tablet_tool *new = (struct libinput_event_tablet_tool *)event;
+	struct libinput_event_tablet_tool *last;
+	struct libinput_event *tail;
+
+	if (libinput_device_config_axis_coalescing_get_enabled(device) !=
+	    LIBINPUT_CONFIG_AXIS_COALESCING_ENABLED)
+		return false;
+
+	tail = libinput_event_queue_tail(
+		libinput_event_queue_for_device(libinput, device));
+	if (!tail)
+		return false;
+
+	if (tail->type != LIBINPUT_EVENT_TABLET_TOOL_AXIS || tail->device != device)
+		return false;
+
+	last = (struct libinput_event_tablet_tool *)tail;
+	if (last->tool != new->tool || last->tip_state != new->tip_state)
+		return false;
+
+	/* A client that doesn't read its events gets a new event rather
+	 * than an ever-growing one */
+	if (last->nsamples >= TABLET_TOOL_MAX_SAMPLES)
+		return false;
+
+	if (last->nsamples == 0 &&
+	    !tablet_tool_event_add_sample(last, last->time, &last->axes))
+		return false;
+
+	if (!tablet_tool_event_add_sample(last, new->time, &new->axes))
+		return false;
+
+	last->time = new->time;
+	new->axes.delta.x += last->axes.delta.x;
+	new->axes.delta.y += last->axes.delta.y;
+	new->axes.wheel += last->axes.wheel;
+	new->axes.wheel_discrete += last->axes.wheel_discrete;
+	last->axes = new->axes;
+	last->abs.x = new->abs.x;
+	last->abs.y = new->abs.y;
+	for (size_t i = 0; i < ARRAY_LENGTH(last->changed_axes); i++)
+		last->changed_axes[i] |= new->changed_axes[i];
+
+	libinput_event_tablet_tool_destroy(new);
+	free(new);
+
+	return true;
+}
+
 static void
 post_device_event(struct libinput_device *device,
 		  uint64_t time,
@@ -2332,6 +2837,10 @@ post_device_event(struct libinput_device *device,
 	list_for_each_safe(listener, &device->event_listeners, link)
 		listener->notify_func(time, event, listener->notify_func_data);
 
+	if (type == LIBINPUT_EVENT_TABLET_TOOL_AXIS &&
+	    tablet_tool_coalesce_axis_event(device, event))
+		return;
+
 	libinput_post_event(device->seat->libinput, event);
 }
 
@@ -3222,80 +3731,37 @@ libinput_print_queued_event(struct libinput_event *event)
 static void
 libinput_post_event(struct libinput *libinput, struct libinput_event *event)
 {
-	struct libinput_event **events = libinput->events;
-	size_t events_len = libinput->events_len;
-	size_t events_count = libinput->events_count;
-	size_t move_len;
-	size_t new_out;
+	struct libinput_event_queue *queue =
+		libinput_event_queue_for_device(libinput, event->device);
 
 #ifdef EVENT_DEBUGGING
 	libinput_print_queued_event(event);
 #endif
 
-	events_count++;
-	if (events_count > events_len) {
-		void *tmp;
-
-		events_len *= 2;
-		tmp = realloc(events, events_len * sizeof *events);
-		if (!tmp) {
-			log_error(libinput,
-				  "Failed to reallocate event ring buffer. "
-				  "Events may be discarded\n");
-			return;
-		}
-
-		events = tmp;
-
-		if (libinput->events_count > 0 && libinput->events_in == 0) {
-			libinput->events_in = libinput->events_len;
-		} else if (libinput->events_count > 0 &&
-			   libinput->events_out >= libinput->events_in) {
-			move_len = libinput->events_len - libinput->events_out;
-			new_out = events_len - move_len;
-			memmove(events + new_out,
-				events + libinput->events_out,
-				move_len * sizeof *events);
-			libinput->events_out = new_out;
-		}
-
-		libinput->events = events;
-		libinput->events_len = events_len;
-	}
-
-	if (event->device)
-		libinput_device_ref(event->device);
-
-	libinput->events_count = events_count;
-	events[libinput->events_in] = event;
-	libinput->events_in = (libinput->events_in + 1) % libinput->events_len;
+	libinput_event_queue_push(libinput, queue, event);
 }
 
 LIBINPUT_EXPORT struct libinput_event *
 libinput_get_event(struct libinput *libinput)
 {
-	struct libinput_event *event;
-
-	if (libinput->events_count == 0)
-		return NULL;
-
-	event = libinput->events[libinput->events_out];
-	libinput->events_out = (libinput->events_out + 1) % libinput->events_len;
-	libinput->events_count--;
+	return libinput_event_queue_pop(&libinput->events);
+}
 
-	return event;
+LIBINPUT_EXPORT struct libinput_event *
+libinput_seat_get_event(struct libinput_seat *seat)
+{
+	return libinput_event_queue_pop(&seat->events);
 }
 
 LIBINPUT_EXPORT enum libinput_event_type
 libinput_next_event_type(struct libinput *libinput)
 {
-	struct libinput_event *event;
+	const struct libinput_event_queue *queue = &libinput->events;
 
-	if (libinput->events_count == 0)
+	if (queue->count == 0)
 		return LIBINPUT_EVENT_NONE;
 
-	event = libinput->events[libinput->events_out];
-	return event->type;
+	return queue->events[queue->out]->type;
 }
 
 LIBINPUT_EXPORT void
@@ -3442,6 +3908,16 @@ libinput_device_touch_get_touch_count(struct libinput_device *device)
 	return evdev_device_get_touch_count((struct evdev_device *)device);
 }
 
+LIBINPUT_EXPORT void
+libinput_device_palm_stats_dump(struct libinput_device *device,
+				libinput_palm_stats_func func,
+				void *user_data)
+{
+	evdev_device_touchpad_palm_stats_dump((struct evdev_device *)device,
+					      func,
+					      user_data);
+}
+
 LIBINPUT_EXPORT int
 libinput_device_switch_has_switch(struct libinput_device *device,
 				  enum libinput_switch sw)
@@ -4259,6 +4735,50 @@ libinput_device_config_area_get_default_rectangle(struct libinput_device *device
 	return device->config.area->get_default_rectangle(device);
 }
 
+LIBINPUT_EXPORT int
+libinput_device_config_axis_coalescing_is_available(struct libinput_device *device)
+{
+	if (!device->config.axis_coalescing)
+		return 0;
+
+	return device->config.axis_coalescing->is_available(device);
+}
+
+LIBINPUT_EXPORT enum libinput_config_status
+libinput_device_config_axis_coalescing_set_enabled(
+	struct libinput_device *device,
+	enum libinput_config_axis_coalescing_state enable)
+{
+	if (enable != LIBINPUT_CONFIG_AXIS_COALESCING_ENABLED &&
+	    enable != LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED)
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+
+	if (!libinput_device_config_axis_coalescing_is_available(device))
+		return enable ? LIBINPUT_CONFIG_STATUS_UNSUPPORTED
+			      : LIBINPUT_CONFIG_STATUS_SUCCESS;
+
+	return device->config.axis_coalescing->set_enabled(device, enable);
+}
+
+LIBINPUT_EXPORT enum libinput_config_axis_coalescing_state
+libinput_device_config_axis_coalescing_get_enabled(struct libinput_device *device)
+{
+	if (!libinput_device_config_axis_coalescing_is_available(device))
+		return LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED;
+
+	return device->config.axis_coalescing->get_enabled(device);
+}
+
+LIBINPUT_EXPORT enum libinput_config_axis_coalescing_state
+libinput_device_config_axis_coalescing_get_default_enabled(
+	struct libinput_device *device)
+{
+	if (!libinput_device_config_axis_coalescing_is_available(device))
+		return LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED;
+
+	return device->config.axis_coalescing->get_default_enabled(device);
+}
+
 LIBINPUT_EXPORT uint32_t
 libinput_device_config_send_events_get_modes(struct libinput_device *device)
 {
@@ -5152,7 +5672,9 @@ libinput_libwacom_ref(struct libinput *li)
 {
 	WacomDeviceDatabase *db = NULL;
 	if (!li->libwacom.db) {
+		size_t span = libinput_trace_begin(li, "libwacom", "load database");
 		db = libwacom_database_new();
+		libinput_trace_end(li, span);
 		if (!db) {
 			log_error(li, "Failed to initialize libwacom context\n");
 			return NULL;
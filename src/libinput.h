@@ -2838,6 +2838,145 @@ libinput_event_tablet_tool_get_time(struct libinput_event_tablet_tool *event);
 uint64_t
 libinput_event_tablet_tool_get_time_usec(struct libinput_event_tablet_tool *event);
 
+/**
+ * @ingroup event_tablet
+ *
+ * Return the number of samples in this event. Unless axis event
+ * coalescing is enabled on the device, this is always 1 and the only
+ * sample is the state of the event itself. Otherwise, a @ref
+ * LIBINPUT_EVENT_TABLET_TOOL_AXIS event may combine several hardware
+ * frames, see libinput_device_config_axis_coalescing_set_enabled().
+ *
+ * Samples are in chronological order, the last sample is the state of
+ * the event itself. An event holds at most 64 samples, further hardware
+ * frames start a new event.
+ *
+ * @param event The libinput tablet tool event
+ * @return The number of samples in this event, always 1 or more
+ *
+ * @since 1.30
+ */
+unsigned int
+libinput_event_tablet_tool_get_sample_count(struct libinput_event_tablet_tool *event);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the timestamp of the given sample in microseconds.
+ *
+ * @param event The libinput tablet tool event
+ * @param sample The sample index, must be less than
+ * libinput_event_tablet_tool_get_sample_count()
+ * @return The time of this sample in microseconds
+ *
+ * @since 1.30
+ */
+uint64_t
+libinput_event_tablet_tool_get_sample_time_usec(struct libinput_event_tablet_tool *event,
+						unsigned int sample);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the X coordinate of the given sample, see
+ * libinput_event_tablet_tool_get_x() for details.
+ *
+ * @param event The libinput tablet tool event
+ * @param sample The sample index, must be less than
+ * libinput_event_tablet_tool_get_sample_count()
+ * @return The current value of the axis in mm
+ *
+ * @since 1.30
+ */
+double
+libinput_event_tablet_tool_get_sample_x(struct libinput_event_tablet_tool *event,
+					unsigned int sample);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the Y coordinate of the given sample, see
+ * libinput_event_tablet_tool_get_y() for details.
+ *
+ * @param event The libinput tablet tool event
+ * @param sample The sample index, must be less than
+ * libinput_event_tablet_tool_get_sample_count()
+ * @return The current value of the axis in mm
+ *
+ * @since 1.30
+ */
+double
+libinput_event_tablet_tool_get_sample_y(struct libinput_event_tablet_tool *event,
+					unsigned int sample);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the pressure of the given sample, see
+ * libinput_event_tablet_tool_get_pressure() for details.
+ *
+ * @param event The libinput tablet tool event
+ * @param sample The sample index, must be less than
+ * libinput_event_tablet_tool_get_sample_count()
+ * @return The current value of the axis
+ *
+ * @since 1.30
+ */
+double
+libinput_event_tablet_tool_get_sample_pressure(struct libinput_event_tablet_tool *event,
+					       unsigned int sample);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the distance of the given sample, see
+ * libinput_event_tablet_tool_get_distance() for details.
+ *
+ * @param event The libinput tablet tool event
+ * @param sample The sample index, must be less than
+ * libinput_event_tablet_tool_get_sample_count()
+ * @return The current value of the axis
+ *
+ * @since 1.30
+ */
+double
+libinput_event_tablet_tool_get_sample_distance(struct libinput_event_tablet_tool *event,
+					       unsigned int sample);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the X tilt of the given sample, see
+ * libinput_event_tablet_tool_get_tilt_x() for details.
+ *
+ * @param event The libinput tablet tool event
+ * @param sample The sample index, must be less than
+ * libinput_event_tablet_tool_get_sample_count()
+ * @return The current value of the axis in degrees
+ *
+ * @since 1.30
+ */
+double
+libinput_event_tablet_tool_get_sample_tilt_x(struct libinput_event_tablet_tool *event,
+					     unsigned int sample);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the Y tilt of the given sample, see
+ * libinput_event_tablet_tool_get_tilt_y() for details.
+ *
+ * @param event The libinput tablet tool event
+ * @param sample The sample index, must be less than
+ * libinput_event_tablet_tool_get_sample_count()
+ * @return The current value of the axis in degrees
+ *
+ * @since 1.30
+ */
+double
+libinput_event_tablet_tool_get_sample_tilt_y(struct libinput_event_tablet_tool *event,
+					     unsigned int sample);
+
 /**
  * @ingroup event_tablet
  *
@@ -4004,6 +4143,100 @@ typedef void (*libinput_log_handler)(struct libinput *libinput,
 void
 libinput_log_set_handler(struct libinput *libinput, libinput_log_handler log_handler);
 
+/**
+ * @ingroup base
+ *
+ * Callback type for libinput_trace_dump(), called once per trace span.
+ *
+ * @param libinput The libinput context
+ * @param device The kernel name of the device (e.g. "event3") or the
+ * subsystem the span belongs to
+ * @param phase A short human-readable description of the phase
+ * @param depth The nesting level of this span, 0 for a top-level span
+ * @param start_usec The start of the span in microseconds, CLOCK_MONOTONIC
+ * @param end_usec The end of the span in microseconds, CLOCK_MONOTONIC
+ * @param user_data The user_data passed to libinput_trace_dump()
+ *
+ * @since 1.30
+ */
+typedef void (*libinput_trace_func)(struct libinput *libinput,
+				    const char *device,
+				    const char *phase,
+				    unsigned int depth,
+				    uint64_t start_usec,
+				    uint64_t end_usec,
+				    void *user_data);
+
+/**
+ * @ingroup base
+ *
+ * Call func for each trace span recorded by this context, in the order
+ * the spans were started. libinput records a span for each phase of
+ * adding a device, e.g. opening the device node, reading the device
+ * state, matching quirks and initializing the device's dispatch. Only the
+ * most recent spans are kept.
+ *
+ * This function is intended for debugging and profiling tools. The set
+ * of phases and their descriptions may change at any time.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param func The function to call for each span
+ * @param user_data Caller-specific data passed to func
+ *
+ * @since 1.30
+ */
+void
+libinput_trace_dump(struct libinput *libinput,
+		    libinput_trace_func func,
+		    void *user_data);
+
+/**
+ * @ingroup device
+ *
+ * Callback type for libinput_device_palm_stats_dump(), called once per
+ * palm detection check.
+ *
+ * @param device The device the statistics belong to
+ * @param check A short human-readable name of the check, e.g. "edge"
+ * @param evaluated The number of times this check ran on a touch
+ * @param triggered The number of times this check labelled a touch as
+ * palm, or, for the "multifinger" check, kept a touch from being labelled
+ * as palm
+ * @param time_nsec The total time spent in this check in nanoseconds,
+ * including any checks it runs itself
+ * @param user_data The user_data passed to libinput_device_palm_stats_dump()
+ *
+ * @since 1.30
+ */
+typedef void (*libinput_palm_stats_func)(struct libinput_device *device,
+					 const char *check,
+					 uint64_t evaluated,
+					 uint64_t triggered,
+					 uint64_t time_nsec,
+					 void *user_data);
+
+/**
+ * @ingroup device
+ *
+ * Call func for each palm detection check of this device, in the order
+ * the checks run on a touch. The statistics accumulate from the time the
+ * device was added. If the device is not a touchpad, func is never
+ * called.
+ *
+ * This function is intended for debugging and profiling tools. The set
+ * of checks and their names may change at any time.
+ *
+ * @param device A current input device
+ * @param func The function to call for each check
+ * @param user_data Caller-specific data passed to func
+ *
+ * @since 1.30
+ */
+void
+libinput_device_palm_stats_dump(struct libinput_device *device,
+				libinput_palm_stats_func func,
+				void *user_data);
+
 /**
  * @defgroup seat Initialization and manipulation of seats
  *
@@ -4110,6 +4343,81 @@ libinput_seat_get_physical_name(struct libinput_seat *seat);
 const char *
 libinput_seat_get_logical_name(struct libinput_seat *seat);
 
+/**
+ * @ingroup seat
+ *
+ * Return a file descriptor for the devices on this seat, to dispatch the
+ * seat separately from the rest of the context. Call into
+ * libinput_seat_dispatch() if any events become available on this fd.
+ *
+ * The first call to this function switches the seat to separate
+ * dispatching. From then on, the seat's devices are no longer
+ * processed by libinput_dispatch() and their events are queued on the
+ * seat. Use libinput_seat_get_event() to retrieve them. Events that
+ * were already queued on the context stay there.
+ *
+ * A seat switched to separate dispatching is kept alive until the
+ * context is destroyed, even when all its devices are removed. Its fd
+ * stays valid and devices added to the seat later are dispatched from
+ * that fd.
+ *
+ * The fd returned by libinput_get_fd() must still be monitored and
+ * libinput_dispatch() called as usual, it handles device hotplug and
+ * timers. Events generated there for this seat's devices, e.g. the
+ * @ref LIBINPUT_EVENT_DEVICE_ADDED event of a new device or a tap that
+ * resolves after a timeout, are queued on the seat too.
+ *
+ * libinput is not thread-safe. This function allows for servicing a
+ * busy seat without delaying other seats but all calls into the same
+ * libinput context, including the per-seat ones, must be serialized by
+ * the caller.
+ *
+ * @param seat A previously obtained seat
+ * @return The file descriptor used to notify of pending events on this
+ * seat, or a negative errno on failure
+ *
+ * @since 1.30
+ */
+int
+libinput_seat_get_fd(struct libinput_seat *seat);
+
+/**
+ * @ingroup seat
+ *
+ * Read events from the devices on this seat and process them internally.
+ * Use libinput_seat_get_event() to retrieve the events. This function
+ * should be called immediately once data is available on the file
+ * descriptor returned by libinput_seat_get_fd().
+ *
+ * It is a client bug to call this function before libinput_seat_get_fd().
+ *
+ * @param seat A previously obtained seat
+ * @return 0 on success, or a negative errno on failure
+ *
+ * @since 1.30
+ */
+int
+libinput_seat_dispatch(struct libinput_seat *seat);
+
+/**
+ * @ingroup seat
+ *
+ * Retrieve the next event from the seat's event queue. Only seats that
+ * have been switched to separate dispatching with libinput_seat_get_fd()
+ * have an event queue, for other seats this function always returns
+ * NULL.
+ *
+ * After handling the retrieved event, the caller must destroy it using
+ * libinput_event_destroy().
+ *
+ * @param seat A previously obtained seat
+ * @return The next available event, or NULL if no event is available.
+ *
+ * @since 1.30
+ */
+struct libinput_event *
+libinput_seat_get_event(struct libinput_seat *seat);
+
 /**
  * @defgroup device Initialization and manipulation of input devices
  */
@@ -5436,6 +5744,118 @@ libinput_device_config_area_get_rectangle(struct libinput_device *device);
 struct libinput_config_area_rectangle
 libinput_device_config_area_get_default_rectangle(struct libinput_device *device);
 
+/**
+ * @ingroup config
+ *
+ * A config status to enable or disable axis event coalescing on a device.
+ *
+ * @since 1.30
+ */
+enum libinput_config_axis_coalescing_state {
+	/**
+	 * One axis event is generated per hardware frame
+	 */
+	LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED,
+	/**
+	 * Consecutive axis events are coalesced into one event carrying all
+	 * samples
+	 */
+	LIBINPUT_CONFIG_AXIS_COALESCING_ENABLED,
+};
+
+/**
+ * @ingroup config
+ *
+ * Check if this device supports axis event coalescing. This is currently
+ * only available on tablet devices.
+ *
+ * @param device The device to check
+ * @return 0 if this device does not support axis event coalescing, or 1
+ * otherwise.
+ *
+ * @see libinput_device_config_axis_coalescing_set_enabled
+ * @see libinput_device_config_axis_coalescing_get_enabled
+ * @see libinput_device_config_axis_coalescing_get_default_enabled
+ *
+ * @since 1.30
+ */
+int
+libinput_device_config_axis_coalescing_is_available(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Enable or disable axis event coalescing on this device. When enabled, a
+ * @ref LIBINPUT_EVENT_TABLET_TOOL_AXIS event that has not yet been
+ * retrieved by the caller with libinput_get_event() is updated in place
+ * when the next axis event for the same tool arrives, provided no other
+ * event was queued in between. The event then carries the state of the
+ * most recent hardware frame and the intermediate states are available
+ * as samples, see libinput_event_tablet_tool_get_sample_count().
+ *
+ * The relative deltas of a coalesced event are the sum of the deltas of
+ * all its samples.
+ *
+ * @param device The device to configure
+ * @param enable @ref LIBINPUT_CONFIG_AXIS_COALESCING_ENABLED to enable,
+ * @ref LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED to disable axis event
+ * coalescing
+ *
+ * @return A config status code. Disabling axis event coalescing on a
+ * device that does not support it always succeeds.
+ *
+ * @see libinput_device_config_axis_coalescing_is_available
+ * @see libinput_device_config_axis_coalescing_get_enabled
+ * @see libinput_device_config_axis_coalescing_get_default_enabled
+ *
+ * @since 1.30
+ */
+enum libinput_config_status
+libinput_device_config_axis_coalescing_set_enabled(
+	struct libinput_device *device,
+	enum libinput_config_axis_coalescing_state enable);
+
+/**
+ * @ingroup config
+ *
+ * Check if axis event coalescing is currently enabled on this device. If
+ * the device does not support axis event coalescing, this function
+ * returns @ref LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED.
+ *
+ * @param device The device to check
+ * @return @ref LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED if disabled, @ref
+ * LIBINPUT_CONFIG_AXIS_COALESCING_ENABLED if enabled.
+ *
+ * @see libinput_device_config_axis_coalescing_is_available
+ * @see libinput_device_config_axis_coalescing_set_enabled
+ * @see libinput_device_config_axis_coalescing_get_default_enabled
+ *
+ * @since 1.30
+ */
+enum libinput_config_axis_coalescing_state
+libinput_device_config_axis_coalescing_get_enabled(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Check if axis event coalescing is enabled on this device by default. If
+ * the device does not support axis event coalescing, this function
+ * returns @ref LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED.
+ *
+ * @param device The device to check
+ * @return @ref LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED if disabled, @ref
+ * LIBINPUT_CONFIG_AXIS_COALESCING_ENABLED if enabled.
+ *
+ * @see libinput_device_config_axis_coalescing_is_available
+ * @see libinput_device_config_axis_coalescing_set_enabled
+ * @see libinput_device_config_axis_coalescing_get_enabled
+ *
+ * @since 1.30
+ */
+enum libinput_config_axis_coalescing_state
+libinput_device_config_axis_coalescing_get_default_enabled(
+	struct libinput_device *device);
+
 /**
  * @ingroup config
  *
@@ -31,15 +31,22 @@
 #undef NDEBUG /* You don't get to disable asserts here */
 #include <assert.h>
 #include <dirent.h>
+#include <fcntl.h>
 #include <fnmatch.h>
 #include <libgen.h>
 #include <libudev.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #ifdef __FreeBSD__
 #include <kenv.h>
 #endif
 
+#include "util-stringbuf.h"
+
 #include "libinput-util.h"
+#include "libinput-version.h"
 #include "libinput-versionsort.h"
 #include "quirks.h"
 
@@ -163,12 +170,31 @@ struct section {
 	char *name; /* the [Section Name] */
 	struct match match;
 	struct list properties;
+
+	size_t index;        /* position in quirks_context.sections */
+	uint32_t prematched; /* match bits already checked against the system */
+
+	/* Loaded from the compiled image: the section and its properties
+	 * are part of the context's image arrays and the strings point
+	 * into the mapped image, see quirks_load_image() */
+	bool in_image;
+};
+
+/**
+ * Index entry for sections matching on a vendor ID, see quirks_build_index()
+ */
+struct quirks_index_entry {
+	uint64_t key; /* quirks_index_key() */
+	struct section *section;
 };
 
 /**
  * The struct returned to the caller. It contains the
  * properties for a given device.
  */
+#define QUIRK_NMODEL_QUIRKS (_QUIRK_LAST_MODEL_QUIRK_ - QUIRK_MODEL_ALPS_SERIAL_TOUCHPAD)
+#define QUIRK_NATTR_QUIRKS (_QUIRK_LAST_ATTR_QUIRK_ - QUIRK_ATTR_SIZE_HINT)
+
 struct quirks {
 	size_t refcount;
 	struct list link; /* struct quirks_context.quirks */
@@ -177,6 +203,9 @@ struct quirks {
 	struct property **properties;
 	size_t nproperties;
 
+	/* The last-assigned property for each quirk, see quirk_slot() */
+	struct property *slots[QUIRK_NMODEL_QUIRKS + QUIRK_NATTR_QUIRKS];
+
 	/* Special properties for AttrEventCode and AttrInputCode, these are
 	 * owned by us, not the section */
 	struct list floating_properties;
@@ -195,10 +224,49 @@ struct quirks_context {
 	char *dmi;
 	char *dt;
 
+	char *data_path;
+	char *override_file;
+
 	struct list sections;
+	size_t nsections;
+	/* The first sections in the list, from the data files. The override
+	 * file's sections follow and are not part of the compiled image */
+	size_t ndata_sections;
+
+	/* The mapped compiled image and the sections and properties loaded
+	 * from it, one allocation each */
+	void *image;
+	size_t image_size;
+	struct section *image_sections;
+	struct property *image_properties;
+
+	/* Sections that can match on this system, split into those that
+	 * match on a vendor ID (sorted by quirks_index_key() and section
+	 * order) and all others (in section order) */
+	struct quirks_index_entry *index;
+	size_t nindex;
+	struct section **residual;
+	size_t nresidual;
 
 	/* list of quirks handed to libinput, just for bookkeeping */
 	struct list quirks;
+
+	/* struct quirks_cache_entry, most recently used first */
+	struct list cache;
+	size_t ncache;
+};
+
+#define QUIRKS_CACHE_SIZE 32
+
+/**
+ * A previous result of quirks_fetch_for_device(), keyed on the match data
+ * of the device. Devices without quirks are cached too, with an empty
+ * struct quirks.
+ */
+struct quirks_cache_entry {
+	struct list link; /* struct quirks_context.cache */
+	struct match *match;
+	struct quirks *quirks; /* ref'd */
 };
 
 LIBINPUT_ATTRIBUTE_PRINTF(3, 0)
@@ -577,6 +645,16 @@ section_destroy(struct section *s)
 {
 	struct property *p;
 
+	if (s->in_image) {
+		list_for_each_safe(p, &s->properties, link) {
+			property_unref(p);
+			assert(p->refcount == 0);
+			list_remove(&p->link);
+		}
+		list_remove(&s->link);
+		return;
+	}
+
 	free(s->name);
 	free(s->match.name);
 	free(s->match.uniq);
@@ -1236,6 +1314,743 @@ parse_files(struct quirks_context *ctx, const char *data_path)
 	return idx == ndev;
 }
 
+/* The compiled quirks image. This is a flat dump of the parsed sections
+ * and their properties, written by quirks_context_compile() into the
+ * data directory and mmap'd on startup instead of parsing the text files.
+ * The image is only used if the hash of the data files it was compiled
+ * from matches the current files, otherwise we fall back to parsing.
+ * The override file is not part of the image, it is parsed on top of
+ * the image or the data files either way.
+ *
+ * The layout is native-endian and uses our in-memory types, it is not
+ * meant to be portable across architectures or libinput versions. The
+ * header records the libinput version and a hash of the quirk enum values
+ * and names, an image from a different build is treated as stale.
+ */
+#define QUIRKS_IMAGE_NAME "quirks.bin"
+#define QUIRKS_IMAGE_MAGIC "LIQUIRKS"
+#define QUIRKS_IMAGE_VERSION 2
+#define QUIRKS_IMAGE_NO_STRING UINT32_MAX
+
+struct quirks_image_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t section_size;  /* sizeof(struct quirks_image_section) */
+	uint32_t property_size; /* sizeof(struct quirks_image_property) */
+	uint32_t size;          /* file size */
+	char libinput_version[32];
+	uint64_t layout_hash; /* quirks_layout_hash() */
+	uint64_t source_hash;
+	uint32_t nsections;
+	uint32_t nproperties;
+	uint32_t sections;   /* offset of the section array */
+	uint32_t properties; /* offset of the property array */
+	uint32_t strings;    /* offset of the string table */
+	uint32_t strings_size;
+};
+
+struct quirks_image_section {
+	/* String table offsets or QUIRKS_IMAGE_NO_STRING */
+	uint32_t name;
+	uint32_t match_name;
+	uint32_t match_uniq;
+	uint32_t match_dmi;
+	uint32_t match_dt;
+
+	uint32_t match_bits;
+	uint32_t bus;
+	uint32_t vendor;
+	uint32_t product[64];
+	uint32_t version;
+	uint32_t udev_type;
+
+	uint32_t first_property;
+	uint32_t nproperties;
+};
+
+struct quirks_image_property {
+	uint32_t id;
+	uint32_t type;
+	uint32_t string; /* for PT_STRING, otherwise QUIRKS_IMAGE_NO_STRING */
+	uint32_t padding;
+	union {
+		bool b;
+		uint32_t u;
+		int32_t i;
+		double d;
+		struct quirk_dimensions dim;
+		struct quirk_range range;
+		struct quirk_tuples tuples;
+		struct quirk_array array;
+	} value;
+};
+
+static_assert(ARRAY_LENGTH(((struct quirks_image_section *)NULL)->product) ==
+		      ARRAY_LENGTH(((struct match *)NULL)->product),
+	      "Image product array size mismatch");
+
+/* 64-bit FNV-1a */
+static inline uint64_t
+quirks_hash_update(uint64_t hash, const void *data, size_t len)
+{
+	const unsigned char *bytes = data;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+static inline uint64_t
+quirks_hash_string(uint64_t hash, const char *str)
+{
+	/* include the terminating null byte as separator */
+	return quirks_hash_update(hash, str, strlen(str) + 1);
+}
+
+/**
+ * Hash the file name and content. The name is passed separately so the
+ * hash doesn't depend on where the data directory is, e.g. an image
+ * compiled during installation into a DESTDIR stays valid.
+ */
+static bool
+quirks_hash_file(uint64_t *hash, const char *name, const char *path)
+{
+	char buf[4096];
+	ssize_t r;
+
+	_autoclose_ int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		/* Same as parse_file(), a missing file is fine and the same as
+		 * not having that file at all */
+		return errno == ENOENT;
+	}
+
+	*hash = quirks_hash_string(*hash, name);
+	while ((r = read(fd, buf, sizeof(buf))) != 0) {
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		*hash = quirks_hash_update(*hash, buf, r);
+	}
+
+	return true;
+}
+
+/**
+ * Hash the values and names of enum quirk, the image stores the values.
+ * Catches renumbering within a libinput version, e.g. a git build.
+ */
+static uint64_t
+quirks_layout_hash(void)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	for (enum quirk q = QUIRK_MODEL_ALPS_SERIAL_TOUCHPAD;
+	     q < _QUIRK_LAST_MODEL_QUIRK_;
+	     q++) {
+		hash = quirks_hash_update(hash, &q, sizeof(q));
+		hash = quirks_hash_string(hash, quirk_get_name(q));
+	}
+
+	for (enum quirk q = QUIRK_ATTR_SIZE_HINT; q < _QUIRK_LAST_ATTR_QUIRK_; q++) {
+		hash = quirks_hash_update(hash, &q, sizeof(q));
+		hash = quirks_hash_string(hash, quirk_get_name(q));
+	}
+
+	return hash;
+}
+
+/**
+ * Hash the content of all data files, in the same order as they are
+ * parsed.
+ */
+static bool
+quirks_hash_sources(const char *data_path, uint64_t *hash_out)
+{
+	struct dirent **namelist;
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	bool rc = true;
+	int ndev;
+
+	ndev = scandir(data_path, &namelist, is_data_file, versionsort);
+	if (ndev <= 0)
+		return false;
+
+	for (int i = 0; i < ndev; i++) {
+		char path[PATH_MAX];
+
+		snprintf(path, sizeof(path), "%s/%s", data_path, namelist[i]->d_name);
+		if (rc)
+			rc = quirks_hash_file(&hash, namelist[i]->d_name, path);
+		free(namelist[i]);
+	}
+	free(namelist);
+
+	*hash_out = hash;
+
+	return rc;
+}
+
+static inline uint32_t
+quirks_image_add_string(struct stringbuf *strings, const char *str)
+{
+	uint32_t offset = strings->len;
+
+	if (!str)
+		return QUIRKS_IMAGE_NO_STRING;
+
+	if (stringbuf_append_string(strings, str) < 0)
+		abort();
+	/* append_string ensured space for the null byte */
+	strings->data[strings->len++] = '\0';
+
+	return offset;
+}
+
+static inline size_t
+quirks_image_align(size_t offset)
+{
+	return (offset + 7) & ~(size_t)7;
+}
+
+bool
+quirks_context_compile(struct quirks_context *ctx)
+{
+	struct quirks_image_header header = {
+		.version = QUIRKS_IMAGE_VERSION,
+		.section_size = sizeof(struct quirks_image_section),
+		.property_size = sizeof(struct quirks_image_property),
+		.layout_hash = quirks_layout_hash(),
+	};
+	struct section *s;
+	struct property *p;
+	size_t nsections = 0, nproperties = 0;
+
+	memcpy(header.magic, QUIRKS_IMAGE_MAGIC, sizeof(header.magic));
+	snprintf(header.libinput_version,
+		 sizeof(header.libinput_version),
+		 "%s",
+		 LIBINPUT_VERSION);
+
+	if (!quirks_hash_sources(ctx->data_path, &header.source_hash)) {
+		qlog_error(ctx, "%s: failed to hash data files\n", ctx->data_path);
+		return false;
+	}
+
+	list_for_each(s, &ctx->sections, link) {
+		if (nsections == ctx->ndata_sections)
+			break;
+		nsections++;
+		list_for_each(p, &s->properties, link)
+			nproperties++;
+	}
+
+	_autofree_ struct quirks_image_section *sections =
+		zalloc(max(nsections, 1U) * sizeof(*sections));
+	_autofree_ struct quirks_image_property *properties =
+		zalloc(max(nproperties, 1U) * sizeof(*properties));
+	_destroy_(stringbuf) *strings = stringbuf_new();
+
+	struct quirks_image_section *is = sections;
+	struct quirks_image_property *ip = properties;
+	list_for_each(s, &ctx->sections, link) {
+		if ((size_t)(is - sections) == nsections)
+			break;
+		is->name = quirks_image_add_string(strings, s->name);
+		is->match_name = quirks_image_add_string(strings, s->match.name);
+		is->match_uniq = quirks_image_add_string(strings, s->match.uniq);
+		is->match_dmi = quirks_image_add_string(strings, s->match.dmi);
+		is->match_dt = quirks_image_add_string(strings, s->match.dt);
+		is->match_bits = s->match.bits;
+		is->bus = s->match.bus;
+		is->vendor = s->match.vendor;
+		memcpy(is->product, s->match.product, sizeof(is->product));
+		is->version = s->match.version;
+		is->udev_type = s->match.udev_type;
+		is->first_property = ip - properties;
+
+		list_for_each(p, &s->properties, link) {
+			ip->id = p->id;
+			ip->type = p->type;
+			ip->string = QUIRKS_IMAGE_NO_STRING;
+			switch (p->type) {
+			case PT_STRING:
+				ip->string = quirks_image_add_string(strings,
+								     p->value.s);
+				break;
+			case PT_BOOL:
+				ip->value.b = p->value.b;
+				break;
+			case PT_UINT:
+				ip->value.u = p->value.u;
+				break;
+			case PT_INT:
+				ip->value.i = p->value.i;
+				break;
+			case PT_DOUBLE:
+				ip->value.d = p->value.d;
+				break;
+			case PT_DIMENSION:
+				ip->value.dim = p->value.dim;
+				break;
+			case PT_RANGE:
+				ip->value.range = p->value.range;
+				break;
+			case PT_TUPLES:
+				ip->value.tuples = p->value.tuples;
+				break;
+			case PT_UINT_ARRAY:
+				ip->value.array = p->value.array;
+				break;
+			}
+			is->nproperties++;
+			ip++;
+		}
+		is++;
+	}
+
+	header.nsections = nsections;
+	header.nproperties = nproperties;
+	header.sections = quirks_image_align(sizeof(header));
+	header.properties =
+		quirks_image_align(header.sections + nsections * sizeof(*sections));
+	header.strings = header.properties + nproperties * sizeof(*properties);
+	header.strings_size = strings->len;
+	header.size = header.strings + header.strings_size;
+
+	_autofree_ char *path =
+		strdup_printf("%s/%s", ctx->data_path, QUIRKS_IMAGE_NAME);
+	_autofree_ char *tmppath =
+		strdup_printf("%s/.%s.XXXXXX", ctx->data_path, QUIRKS_IMAGE_NAME);
+	_autoclose_ int fd = mkstemp(tmppath);
+	if (fd < 0) {
+		qlog_error(ctx, "%s: failed to create file: %m\n", tmppath);
+		return false;
+	}
+
+	const char zeroes[8] = { 0 };
+	struct {
+		const void *data;
+		size_t len;
+		size_t pad;
+	} chunks[] = {
+		{ &header, sizeof(header), header.sections - sizeof(header) },
+		{ sections,
+		  nsections * sizeof(*sections),
+		  header.properties - header.sections - nsections * sizeof(*sections) },
+		{ properties, nproperties * sizeof(*properties), 0 },
+		{ strings->data, strings->len, 0 },
+	};
+
+	bool rc = fchmod(fd, 0644) == 0;
+	ARRAY_FOR_EACH(chunks, c) {
+		if (!rc)
+			break;
+		rc = write(fd, c->data, c->len) == (ssize_t)c->len &&
+		     write(fd, zeroes, c->pad) == (ssize_t)c->pad;
+	}
+
+	if (rc)
+		rc = fsync(fd) == 0 && rename(tmppath, path) == 0;
+
+	if (!rc) {
+		qlog_error(ctx, "%s: failed to write quirks image: %m\n", path);
+		unlink(tmppath);
+		return false;
+	}
+
+	qlog_debug(ctx,
+		   "%s: compiled %zu sections, %zu properties\n",
+		   path,
+		   nsections,
+		   nproperties);
+
+	return true;
+}
+
+static inline const char *
+quirks_image_string(const struct quirks_image_header *header, uint32_t offset)
+{
+	const char *strings = (const char *)header + header->strings;
+
+	if (offset == QUIRKS_IMAGE_NO_STRING)
+		return NULL;
+
+	return &strings[offset];
+}
+
+static bool
+quirks_image_validate(const struct quirks_image_header *header,
+		      size_t size,
+		      uint64_t source_hash)
+{
+	if (size < sizeof(*header) ||
+	    memcmp(header->magic, QUIRKS_IMAGE_MAGIC, sizeof(header->magic)) != 0 ||
+	    header->version != QUIRKS_IMAGE_VERSION ||
+	    header->section_size != sizeof(struct quirks_image_section) ||
+	    header->property_size != sizeof(struct quirks_image_property) ||
+	    strncmp(header->libinput_version,
+		    LIBINPUT_VERSION,
+		    sizeof(header->libinput_version)) != 0 ||
+	    header->layout_hash != quirks_layout_hash() || header->size != size ||
+	    header->source_hash != source_hash)
+		return false;
+
+	uint64_t sections_end = (uint64_t)header->sections +
+				(uint64_t)header->nsections * header->section_size;
+	uint64_t properties_end =
+		(uint64_t)header->properties +
+		(uint64_t)header->nproperties * header->property_size;
+	uint64_t strings_end = (uint64_t)header->strings + header->strings_size;
+
+	if (header->sections < sizeof(*header) || header->sections % 8 ||
+	    header->properties < sections_end || header->properties % 8 ||
+	    header->strings < properties_end || strings_end > size)
+		return false;
+
+	const char *strings = (const char *)header + header->strings;
+	if (header->strings_size == 0 || strings[header->strings_size - 1] != '\0')
+		return false;
+
+#define valid_string(o_) \
+	((o_) == QUIRKS_IMAGE_NO_STRING || (o_) < header->strings_size)
+
+	const struct quirks_image_section *sections =
+		(const void *)((const char *)header + header->sections);
+	for (size_t i = 0; i < header->nsections; i++) {
+		const struct quirks_image_section *is = &sections[i];
+
+		if (is->name == QUIRKS_IMAGE_NO_STRING || !valid_string(is->name) ||
+		    !valid_string(is->match_name) || !valid_string(is->match_uniq) ||
+		    !valid_string(is->match_dmi) || !valid_string(is->match_dt) ||
+		    is->product[ARRAY_LENGTH(is->product) - 1] != 0 ||
+		    is->nproperties == 0 || is->first_property > header->nproperties ||
+		    is->nproperties > header->nproperties - is->first_property)
+			return false;
+	}
+
+	const struct quirks_image_property *properties =
+		(const void *)((const char *)header + header->properties);
+	for (size_t i = 0; i < header->nproperties; i++) {
+		const struct quirks_image_property *ip = &properties[i];
+		bool valid_id = (ip->id >= QUIRK_MODEL_ALPS_SERIAL_TOUCHPAD &&
+				 ip->id < _QUIRK_LAST_MODEL_QUIRK_) ||
+				(ip->id >= QUIRK_ATTR_SIZE_HINT &&
+				 ip->id < _QUIRK_LAST_ATTR_QUIRK_);
+
+		if (!valid_id || ip->type > PT_UINT_ARRAY || !valid_string(ip->string))
+			return false;
+
+		switch (ip->type) {
+		case PT_STRING:
+			if (ip->string == QUIRKS_IMAGE_NO_STRING)
+				return false;
+			break;
+		case PT_TUPLES:
+			if (ip->value.tuples.ntuples >
+			    ARRAY_LENGTH(ip->value.tuples.tuples))
+				return false;
+			break;
+		case PT_UINT_ARRAY:
+			if (ip->value.array.nelements >
+			    ARRAY_LENGTH(ip->value.array.data.u))
+				return false;
+			break;
+		default:
+			break;
+		}
+	}
+#undef valid_string
+
+	return true;
+}
+
+/**
+ * Fill in a section and its properties from the image. Strings are not
+ * copied, they point into the mapped image which lives as long as the
+ * context.
+ */
+static void
+section_init_from_image(struct section *s,
+			struct property *props,
+			const struct quirks_image_header *header,
+			const struct quirks_image_section *is)
+{
+	const struct quirks_image_property *properties =
+		(const void *)((const char *)header + header->properties);
+
+	list_init(&s->link);
+	list_init(&s->properties);
+	s->in_image = true;
+	s->has_match = true;
+	s->has_property = true;
+	s->name = (char *)quirks_image_string(header, is->name);
+	s->match.name = (char *)quirks_image_string(header, is->match_name);
+	s->match.uniq = (char *)quirks_image_string(header, is->match_uniq);
+	s->match.dmi = (char *)quirks_image_string(header, is->match_dmi);
+	s->match.dt = (char *)quirks_image_string(header, is->match_dt);
+	s->match.bits = is->match_bits;
+	s->match.bus = is->bus;
+	s->match.vendor = is->vendor;
+	memcpy(s->match.product, is->product, sizeof(s->match.product));
+	s->match.version = is->version;
+	s->match.udev_type = is->udev_type;
+
+	for (size_t i = 0; i < is->nproperties; i++) {
+		const struct quirks_image_property *ip =
+			&properties[is->first_property + i];
+		struct property *p = &props[is->first_property + i];
+
+		p->refcount = 1;
+		p->id = ip->id;
+		p->type = ip->type;
+		switch (p->type) {
+		case PT_STRING:
+			p->value.s = (char *)quirks_image_string(header, ip->string);
+			break;
+		case PT_BOOL:
+			p->value.b = ip->value.b;
+			break;
+		case PT_UINT:
+			p->value.u = ip->value.u;
+			break;
+		case PT_INT:
+			p->value.i = ip->value.i;
+			break;
+		case PT_DOUBLE:
+			p->value.d = ip->value.d;
+			break;
+		case PT_DIMENSION:
+			p->value.dim = ip->value.dim;
+			break;
+		case PT_RANGE:
+			p->value.range = ip->value.range;
+			break;
+		case PT_TUPLES:
+			p->value.tuples = ip->value.tuples;
+			break;
+		case PT_UINT_ARRAY:
+			p->value.array = ip->value.array;
+			break;
+		}
+		list_append(&s->properties, &p->link);
+	}
+}
+
+/**
+ * Load the sections from the compiled image in the data directory, if
+ * there is one and it is up-to-date.
+ *
+ * @return true if the image was loaded, false if the text files need to
+ * be parsed.
+ */
+static bool
+quirks_load_image(struct quirks_context *ctx)
+{
+	_autofree_ char *path =
+		strdup_printf("%s/%s", ctx->data_path, QUIRKS_IMAGE_NAME);
+	struct stat st;
+	uint64_t hash;
+
+	_autoclose_ int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(struct quirks_image_header) ||
+	    st.st_size > UINT32_MAX)
+		return false;
+
+	if (!quirks_hash_sources(ctx->data_path, &hash))
+		return false;
+
+	void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED)
+		return false;
+
+	const struct quirks_image_header *header = map;
+	if (!quirks_image_validate(header, st.st_size, hash)) {
+		qlog_debug(ctx, "%s: stale or invalid, parsing data files\n", path);
+		munmap(map, st.st_size);
+		return false;
+	}
+
+	/* Sections and properties need to be writable and have list links,
+	 * so they can't live in the image itself. Allocate them in one block
+	 * each instead of one allocation per entry, the strings stay in the
+	 * mapping */
+	ctx->image = map;
+	ctx->image_size = st.st_size;
+	ctx->image_sections =
+		zalloc(max(header->nsections, 1U) * sizeof(*ctx->image_sections));
+	ctx->image_properties =
+		zalloc(max(header->nproperties, 1U) * sizeof(*ctx->image_properties));
+
+	const struct quirks_image_section *sections =
+		(const void *)((const char *)header + header->sections);
+	for (size_t i = 0; i < header->nsections; i++) {
+		struct section *s = &ctx->image_sections[i];
+
+		section_init_from_image(s, ctx->image_properties, header, &sections[i]);
+		list_append(&ctx->sections, &s->link);
+	}
+
+	ctx->ndata_sections = header->nsections;
+	qlog_debug(ctx, "%s: loaded %u sections\n", path, header->nsections);
+
+	return true;
+}
+
+/* Product IDs are 16 bit, this is the key for sections without a
+ * MatchProduct */
+#define QUIRKS_INDEX_ANY_PRODUCT 0x10000
+
+/* The vendor goes above the 17 product bits, this doesn't fit into
+ * 32 bits for vendor IDs >= 0x8000 */
+static inline uint64_t
+quirks_index_key(uint32_t vendor, uint32_t product)
+{
+	return ((uint64_t)vendor << 17) | product;
+}
+
+static int
+quirks_index_entry_cmp(const void *a, const void *b)
+{
+	const struct quirks_index_entry *ea = a;
+	const struct quirks_index_entry *eb = b;
+
+	if (ea->key != eb->key)
+		return ea->key < eb->key ? -1 : 1;
+
+	if (ea->section->index != eb->section->index)
+		return ea->section->index < eb->section->index ? -1 : 1;
+
+	return 0;
+}
+
+/**
+ * Check the system-wide DMI and device tree matches of this section, these
+ * are the same for every device.
+ *
+ * @return false if this section can never match on this system
+ */
+static bool
+section_match_system(struct quirks_context *ctx, struct section *s)
+{
+	if (s->match.bits & M_DMI) {
+		if (!ctx->dmi || fnmatch(s->match.dmi, ctx->dmi, 0) != 0)
+			return false;
+		s->prematched |= M_DMI;
+	}
+
+	if (s->match.bits & M_DT) {
+		if (!ctx->dt || fnmatch(s->match.dt, ctx->dt, 0) != 0)
+			return false;
+		s->prematched |= M_DT;
+	}
+
+	return true;
+}
+
+/**
+ * Build the lookup index for quirks_fetch_for_device(). Sections that
+ * cannot match on this system are dropped, sections with a MatchVendor
+ * are indexed by vendor and product ID, everything else is kept in
+ * the residual list that is checked for every device.
+ */
+static void
+quirks_build_index(struct quirks_context *ctx)
+{
+	struct section *s;
+	size_t nindex = 0;
+
+	list_for_each(s, &ctx->sections, link) {
+		s->index = ctx->nsections++;
+
+		if ((s->match.bits & M_VID) == 0)
+			continue;
+
+		if ((s->match.bits & M_PID) == 0) {
+			nindex++;
+			continue;
+		}
+
+		ARRAY_FOR_EACH(s->match.product, pid) {
+			if (*pid == 0)
+				break;
+			nindex++;
+		}
+	}
+
+	ctx->index = zalloc(max(nindex, 1U) * sizeof(*ctx->index));
+	ctx->residual = zalloc(max(ctx->nsections, 1U) * sizeof(*ctx->residual));
+
+	list_for_each(s, &ctx->sections, link) {
+		if (!section_match_system(ctx, s))
+			continue;
+
+		if ((s->match.bits & M_VID) == 0) {
+			ctx->residual[ctx->nresidual++] = s;
+			continue;
+		}
+
+		if ((s->match.bits & M_PID) == 0) {
+			ctx->index[ctx->nindex++] = (struct quirks_index_entry){
+				.key = quirks_index_key(s->match.vendor,
+							QUIRKS_INDEX_ANY_PRODUCT),
+				.section = s,
+			};
+			continue;
+		}
+
+		ARRAY_FOR_EACH(s->match.product, pid) {
+			if (*pid == 0)
+				break;
+			ctx->index[ctx->nindex++] = (struct quirks_index_entry){
+				.key = quirks_index_key(s->match.vendor, *pid),
+				.section = s,
+			};
+		}
+	}
+
+	qsort(ctx->index, ctx->nindex, sizeof(*ctx->index), quirks_index_entry_cmp);
+
+	qlog_debug(ctx,
+		   "%zu sections: %zu index entries, %zu residual\n",
+		   ctx->nsections,
+		   ctx->nindex,
+		   ctx->nresidual);
+}
+
+/**
+ * Find the range of index entries for the given key.
+ */
+static struct quirks_index_entry *
+quirks_index_lookup(struct quirks_context *ctx, uint64_t key, size_t *nentries)
+{
+	size_t lo = 0, hi = ctx->nindex;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (ctx->index[mid].key < key)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	size_t end = lo;
+	while (end < ctx->nindex && ctx->index[end].key == key)
+		end++;
+
+	*nentries = end - lo;
+
+	return &ctx->index[lo];
+}
+
 struct quirks_context *
 quirks_init_subsystem(const char *data_path,
 		      const char *override_file,
@@ -1251,8 +2066,11 @@ quirks_init_subsystem(const char *data_path,
 	ctx->log_handler = log_handler;
 	ctx->log_type = log_type;
 	ctx->libinput = libinput;
+	ctx->data_path = safe_strdup(data_path);
+	ctx->override_file = override_file ? safe_strdup(override_file) : NULL;
 	list_init(&ctx->quirks);
 	list_init(&ctx->sections);
+	list_init(&ctx->cache);
 
 	qlog_debug(ctx, "%s is data root\n", data_path);
 
@@ -1261,12 +2079,21 @@ quirks_init_subsystem(const char *data_path,
 	if (!ctx->dmi && !ctx->dt)
 		return NULL;
 
-	if (!parse_files(ctx, data_path))
-		return NULL;
+	if (!quirks_load_image(ctx)) {
+		struct section *s;
+
+		if (!parse_files(ctx, data_path))
+			return NULL;
+
+		list_for_each(s, &ctx->sections, link)
+			ctx->ndata_sections++;
+	}
 
 	if (override_file && !parse_file(ctx, override_file))
 		return NULL;
 
+	quirks_build_index(ctx);
+
 	return steal(&ctx);
 }
 
@@ -1279,6 +2106,9 @@ quirks_context_ref(struct quirks_context *ctx)
 	return ctx;
 }
 
+static void
+quirks_cache_flush(struct quirks_context *ctx);
+
 struct quirks_context *
 quirks_context_unref(struct quirks_context *ctx)
 {
@@ -1293,6 +2123,8 @@ quirks_context_unref(struct quirks_context *ctx)
 	if (ctx->refcount > 0)
 		return NULL;
 
+	quirks_cache_flush(ctx);
+
 	/* Caller needs to clean up before calling this */
 	assert(list_empty(&ctx->quirks));
 
@@ -1300,8 +2132,17 @@ quirks_context_unref(struct quirks_context *ctx)
 		section_destroy(s);
 	}
 
+	free(ctx->image_sections);
+	free(ctx->image_properties);
+	if (ctx->image)
+		munmap(ctx->image, ctx->image_size);
+
 	free(ctx->dmi);
 	free(ctx->dt);
+	free(ctx->data_path);
+	free(ctx->override_file);
+	free(ctx->index);
+	free(ctx->residual);
 	free(ctx);
 
 	return NULL;
@@ -1327,9 +2168,11 @@ quirks_unref(struct quirks *q)
 	if (!q)
 		return NULL;
 
-	/* We don't really refcount, but might
-	 * as well have the API in place */
-	assert(q->refcount == 1);
+	/* The same quirks may be handed to several callers and
+	 * held by the cache in the context */
+	assert(q->refcount > 0);
+	if (--q->refcount > 0)
+		return NULL;
 
 	for (size_t i = 0; i < q->nproperties; i++) {
 		property_unref(q->properties[i]);
@@ -1349,6 +2192,15 @@ quirks_unref(struct quirks *q)
 	return NULL;
 }
 
+static struct quirks *
+quirks_ref(struct quirks *q)
+{
+	assert(q->refcount > 0);
+	q->refcount++;
+
+	return q;
+}
+
 /**
  * Searches for the udev property on this device and its parent devices.
  *
@@ -1522,17 +2374,122 @@ match_free(struct match *m)
 
 DEFINE_FREE_CLEANUP_FUNC(match);
 
+static bool
+match_equal(const struct match *a, const struct match *b)
+{
+	/* dmi and dt are global, no need to compare them */
+	if (a->bits != b->bits)
+		return false;
+
+	if ((a->bits & M_NAME) && !streq(a->name, b->name))
+		return false;
+
+	if ((a->bits & M_UNIQ) && !streq(a->uniq, b->uniq))
+		return false;
+
+	if ((a->bits & M_BUS) && a->bus != b->bus)
+		return false;
+
+	if ((a->bits & M_VID) && a->vendor != b->vendor)
+		return false;
+
+	if ((a->bits & M_PID) && a->product[0] != b->product[0])
+		return false;
+
+	if ((a->bits & M_VERSION) && a->version != b->version)
+		return false;
+
+	return a->udev_type == b->udev_type;
+}
+
+static void
+quirks_cache_entry_destroy(struct quirks_cache_entry *e)
+{
+	list_remove(&e->link);
+	match_free(e->match);
+	quirks_unref(e->quirks);
+	free(e);
+}
+
+static void
+quirks_cache_flush(struct quirks_context *ctx)
+{
+	struct quirks_cache_entry *e;
+
+	list_for_each_safe(e, &ctx->cache, link) {
+		quirks_cache_entry_destroy(e);
+	}
+	ctx->ncache = 0;
+}
+
+/**
+ * @return the cached quirks for this match or NULL if there are none.
+ * The returned quirks are not ref'd and may be empty.
+ */
+static struct quirks *
+quirks_cache_lookup(struct quirks_context *ctx, const struct match *m)
+{
+	struct quirks_cache_entry *e;
+
+	list_for_each(e, &ctx->cache, link) {
+		if (match_equal(e->match, m)) {
+			list_remove(&e->link);
+			list_insert(&ctx->cache, &e->link);
+			return e->quirks;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Add the quirks for this match to the cache, evicting the least recently
+ * used entry if need be. The cache takes ownership of the match.
+ */
+static void
+quirks_cache_add(struct quirks_context *ctx, struct match *m, struct quirks *q)
+{
+	if (ctx->ncache == QUIRKS_CACHE_SIZE) {
+		struct quirks_cache_entry *oldest = NULL;
+
+		oldest = list_last_entry(&ctx->cache, oldest, link);
+		quirks_cache_entry_destroy(oldest);
+		ctx->ncache--;
+	}
+
+	struct quirks_cache_entry *e = zalloc(sizeof *e);
+	e->match = m;
+	e->quirks = quirks_ref(q);
+	list_insert(&ctx->cache, &e->link);
+	ctx->ncache++;
+}
+
+/**
+ * Maps a quirk to its index in struct quirks.slots, or -1 for values
+ * outside the model and attribute ranges.
+ */
+static inline int
+quirk_slot(enum quirk which)
+{
+	if (which >= QUIRK_MODEL_ALPS_SERIAL_TOUCHPAD &&
+	    which < _QUIRK_LAST_MODEL_QUIRK_)
+		return which - QUIRK_MODEL_ALPS_SERIAL_TOUCHPAD;
+
+	if (which >= QUIRK_ATTR_SIZE_HINT && which < _QUIRK_LAST_ATTR_QUIRK_)
+		return QUIRK_NMODEL_QUIRKS + which - QUIRK_ATTR_SIZE_HINT;
+
+	return -1;
+}
+
 static void
 quirk_merge_event_codes(struct quirks_context *ctx,
 			struct quirks *q,
 			const struct property *property)
 {
-	for (size_t i = 0; i < q->nproperties; i++) {
-		struct property *p = q->properties[i];
-
-		if (p->id != property->id)
-			continue;
+	int slot = quirk_slot(property->id);
+	struct property *p = q->slots[slot];
 
+	if (p) {
 		/* We have a duplicated property, merge in with ours */
 		size_t offset = p->value.tuples.ntuples;
 		size_t max = ARRAY_LENGTH(p->value.tuples.tuples);
@@ -1555,6 +2512,7 @@ quirk_merge_event_codes(struct quirks_context *ctx,
 	newprop->value.tuples = property->value.tuples;
 	/* Caller responsible for pre-allocating space */
 	q->properties[q->nproperties++] = property_ref(newprop);
+	q->slots[slot] = newprop;
 	list_append(&q->floating_properties, &newprop->link);
 }
 
@@ -1597,11 +2555,16 @@ quirk_apply_section(struct quirks_context *ctx,
 		 * To hack around this, those are the only ones where only ever
 		 * have one struct property in the list (not owned by a section)
 		 * and we simply merge any extra sections onto that.
+		 *
+		 * The getters only ever look at the slot, so the last one
+		 * assigned is the one that takes effect.
 		 */
-		if (p->id == QUIRK_ATTR_EVENT_CODE || p->id == QUIRK_ATTR_INPUT_PROP)
+		if (p->id == QUIRK_ATTR_EVENT_CODE || p->id == QUIRK_ATTR_INPUT_PROP) {
 			quirk_merge_event_codes(ctx, q, p);
-		else
+		} else {
 			q->properties[q->nproperties++] = property_ref(p);
+			q->slots[quirk_slot(p->id)] = p;
+		}
 	}
 }
 
@@ -1620,6 +2583,12 @@ quirk_match_section(struct quirks_context *ctx,
 		if ((s->match.bits & flag) == 0)
 			continue;
 
+		/* already checked in quirks_build_index() */
+		if (s->prematched & flag) {
+			matched_flags |= flag;
+			continue;
+		}
+
 		/* Couldn't fill in this bit for the match, so we
 		 * do not match on it */
 		if ((m->bits & flag) == 0) {
@@ -1707,19 +2676,89 @@ quirks_fetch_for_device(struct quirks_context *ctx, struct udev_device *udev_dev
 
 	qlog_debug(ctx, "%s: fetching quirks\n", udev_device_get_devnode(udev_device));
 
-	_unref_(quirks) *q = quirks_new();
 	_free_(match) *m = match_new(udev_device, ctx->dmi, ctx->dt);
 
-	struct section *s;
-	list_for_each(s, &ctx->sections, link) {
-		quirk_match_section(ctx, q, s, m, udev_device);
+	struct quirks *cached = quirks_cache_lookup(ctx, m);
+	if (cached) {
+		qlog_debug(ctx,
+			   "%s: using cached quirks\n",
+			   udev_device_get_devnode(udev_device));
+		return cached->nproperties > 0 ? quirks_ref(cached) : NULL;
 	}
 
-	if (q->nproperties == 0) {
-		return NULL;
+	_unref_(quirks) *q = quirks_new();
+
+	/* Candidates are the residual sections plus the indexed ones for
+	 * our vendor and product ID. All three are in section order, merge
+	 * them so later sections still override earlier ones */
+	struct {
+		struct section **residual;
+		struct quirks_index_entry *entries;
+		size_t n;
+	} candidates[3] = {
+		{ .residual = ctx->residual, .n = ctx->nresidual },
+	};
+
+	if (m->bits & M_VID) {
+		uint64_t any = quirks_index_key(m->vendor, QUIRKS_INDEX_ANY_PRODUCT);
+		candidates[1].entries = quirks_index_lookup(ctx, any, &candidates[1].n);
+
+		if (m->bits & M_PID) {
+			uint64_t key = quirks_index_key(m->vendor, m->product[0]);
+			candidates[2].entries =
+				quirks_index_lookup(ctx, key, &candidates[2].n);
+		}
 	}
 
+	struct section *prev = NULL;
+	size_t nevaluated = 0;
+	while (true) {
+		struct section *next = NULL;
+		size_t which = 0;
+
+		for (size_t i = 0; i < ARRAY_LENGTH(candidates); i++) {
+			if (candidates[i].n == 0)
+				continue;
+
+			struct section *s = candidates[i].residual
+						    ? candidates[i].residual[0]
+						    : candidates[i].entries[0].section;
+			if (!next || s->index < next->index) {
+				next = s;
+				which = i;
+			}
+		}
+
+		if (!next)
+			break;
+
+		if (candidates[which].residual)
+			candidates[which].residual++;
+		else
+			candidates[which].entries++;
+		candidates[which].n--;
+
+		/* A duplicate product ID in MatchProduct */
+		if (next == prev)
+			continue;
+
+		quirk_match_section(ctx, q, next, m, udev_device);
+		nevaluated++;
+		prev = next;
+	}
+
+	qlog_debug(ctx,
+		   "%s: evaluated %zu of %zu sections\n",
+		   udev_device_get_devnode(udev_device),
+		   nevaluated,
+		   ctx->nsections);
+
 	list_insert(&ctx->quirks, &q->link);
+	quirks_cache_add(ctx, steal(&m), q);
+
+	if (q->nproperties == 0) {
+		return NULL;
+	}
 
 	return steal(&q);
 }
@@ -1727,14 +2766,9 @@ quirks_fetch_for_device(struct quirks_context *ctx, struct udev_device *udev_dev
 static inline struct property *
 quirk_find_prop(struct quirks *q, enum quirk which)
 {
-	/* Run backwards to only handle the last one assigned */
-	for (ssize_t i = q->nproperties - 1; i >= 0; i--) {
-		struct property *p = q->properties[i];
-		if (p->id == which)
-			return p;
-	}
+	int slot = quirk_slot(which);
 
-	return NULL;
+	return slot >= 0 ? q->slots[slot] : NULL;
 }
 
 bool
@@ -191,11 +191,27 @@ DEFINE_UNREF_CLEANUP_FUNC(quirks_context);
 struct quirks_context *
 quirks_context_ref(struct quirks_context *ctx);
 
+/**
+ * Write the sections of this context into a compiled image in the data
+ * directory. Subsequent calls to quirks_init_subsystem() with the same
+ * data directory load that image instead of parsing the data files, for
+ * as long as the data files are unchanged. The override file is not
+ * part of the image, it is always parsed on top of the image.
+ *
+ * @return true on success, false otherwise
+ */
+bool
+quirks_context_compile(struct quirks_context *ctx);
+
 /**
  * Fetch the quirks for a given device. If no quirks are defined, this
  * function returns NULL.
  *
- * @return A new quirks struct, use quirks_unref() to release
+ * The result is cached in the context: devices with the same name, uniq,
+ * bus, vendor, product, version and udev type get the same quirks struct
+ * until the context is released.
+ *
+ * @return A ref'd quirks struct, use quirks_unref() to release
  */
 struct quirks *
 quirks_fetch_for_device(struct quirks_context *ctx, struct udev_device *device);
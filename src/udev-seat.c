@@ -44,50 +44,57 @@ udev_seat_get_named(struct udev_input *input, const char *seat_name);
 static inline bool
 filter_duplicates(struct udev_seat *udev_seat, struct udev_device *udev_device)
 {
-	struct libinput_device *device;
+	struct libinput *libinput;
+	struct evdev_device *device;
 	const char *new_syspath = udev_device_get_syspath(udev_device);
-	bool ignore_device = false;
 
-	if (!udev_seat)
+	if (!udev_seat || !new_syspath)
 		return false;
 
-	list_for_each(device, &udev_seat->base.devices_list, link) {
-		const char *syspath;
+	libinput = udev_seat->base.libinput;
+	list_for_each(device,
+		      libinput_device_table_bucket(libinput, new_syspath),
+		      table_link) {
+		if (device->base.seat == &udev_seat->base &&
+		    streq(udev_device_get_syspath(device->udev_device), new_syspath))
+			return true;
+	}
 
-		_unref_(udev_device) *ud = libinput_device_get_udev_device(device);
-		if (!ud)
-			continue;
+	return false;
+}
 
-		syspath = udev_device_get_syspath(ud);
-		if (syspath && new_syspath && streq(syspath, new_syspath))
-			ignore_device = true;
+static inline const char *
+device_get_seat(struct udev_device *udev_device)
+{
+	const char *device_seat =
+		udev_device_get_property_value(udev_device, "ID_SEAT");
 
-		if (ignore_device)
-			break;
-	}
+	return device_seat ? device_seat : default_seat;
+}
+
+static inline bool
+device_is_wanted(struct udev_device *udev_device, struct udev_input *input)
+{
+	if (!streq(device_get_seat(udev_device), input->seat_id))
+		return false;
 
-	return ignore_device;
+	if (ignore_litest_test_suite_device(udev_device))
+		return false;
+
+	return true;
 }
 
 static int
-device_added(struct udev_device *udev_device,
-	     struct udev_input *input,
-	     const char *seat_name)
+device_create(struct udev_device *udev_device,
+	      struct udev_input *input,
+	      const char *seat_name)
 {
 	struct evdev_device *device;
 	const char *devnode, *sysname;
 	const char *device_seat, *output_name;
 	struct udev_seat *seat;
 
-	device_seat = udev_device_get_property_value(udev_device, "ID_SEAT");
-	if (!device_seat)
-		device_seat = default_seat;
-
-	if (!streq(device_seat, input->seat_id))
-		return 0;
-
-	if (ignore_litest_test_suite_device(udev_device))
-		return 0;
+	device_seat = device_get_seat(udev_device);
 
 	devnode = udev_device_get_devnode(udev_device);
 	sysname = udev_device_get_sysname(udev_device);
@@ -142,22 +149,38 @@ device_added(struct udev_device *udev_device,
 	return 0;
 }
 
+static int
+device_added(struct udev_device *udev_device,
+	     struct udev_input *input,
+	     const char *seat_name)
+{
+	if (!device_is_wanted(udev_device, input))
+		return 0;
+
+	size_t span = libinput_trace_begin(&input->base,
+					   udev_device_get_sysname(udev_device),
+					   "device added");
+	int rc = device_create(udev_device, input, seat_name);
+	libinput_trace_end(&input->base, span);
+
+	return rc;
+}
+
 static void
 device_removed(struct udev_device *udev_device, struct udev_input *input)
 {
 	struct evdev_device *device;
-	struct udev_seat *seat;
 	const char *syspath;
 
 	syspath = udev_device_get_syspath(udev_device);
-	list_for_each(seat, &input->base.seat_list, base.link) {
-		list_for_each_safe(device, &seat->base.devices_list, base.link) {
-			if (streq(syspath,
-				  udev_device_get_syspath(device->udev_device))) {
-				evdev_device_remove(device);
-				break;
-			}
-		}
+	if (!syspath)
+		return;
+
+	list_for_each_safe(device,
+			   libinput_device_table_bucket(&input->base, syspath),
+			   table_link) {
+		if (streq(syspath, udev_device_get_syspath(device->udev_device)))
+			evdev_device_remove(device);
 	}
 }
 
@@ -166,9 +189,12 @@ udev_input_add_devices(struct udev_input *input, struct udev *udev)
 {
 	struct udev_list_entry *entry;
 
+	size_t span = libinput_trace_begin(&input->base, "udev", "enumerate");
 	_unref_(udev_enumerate) *e = udev_enumerate_new(udev);
 	udev_enumerate_add_match_subsystem(e, "input");
 	udev_enumerate_scan_devices(e);
+	libinput_trace_end(&input->base, span);
+
 	udev_list_entry_foreach(entry, udev_enumerate_get_list_entry(e)) {
 		const char *path = udev_list_entry_get_name(entry);
 		_unref_(udev_device) *device = udev_device_new_from_syspath(udev, path);
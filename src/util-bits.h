@@ -105,6 +105,39 @@ long_any_bit_set(unsigned long *array, size_t size)
 	return false;
 }
 
+/**
+ * Return the index of the first bit set at or after from in an array of
+ * nlongs longs, or -1 if no bit is set.
+ */
+static inline int
+long_bit_find_next_set(const unsigned long *array, size_t nlongs, unsigned int from)
+{
+	size_t idx = from / LONG_BITS;
+	unsigned long word;
+
+	if (idx >= nlongs)
+		return -1;
+
+	word = array[idx] & (~0UL << (from % LONG_BITS));
+	while (word == 0) {
+		if (++idx >= nlongs)
+			return -1;
+		word = array[idx];
+	}
+
+	return idx * LONG_BITS + __builtin_ctzl(word);
+}
+
+/**
+ * Iterate over all bits set in an array of nlongs longs. The bit is
+ * declared as int within the loop. Bits may be cleared inside the loop,
+ * bits set at an index lower than the current one are not visited.
+ */
+#define long_for_each_bit_set(_array, _nlongs, _bit) \
+	for (int _bit = long_bit_find_next_set(_array, _nlongs, 0); \
+	     _bit >= 0; \
+	     _bit = long_bit_find_next_set(_array, _nlongs, _bit + 1))
+
 /* A wrapper around a bit mask to avoid type confusion */
 typedef struct {
 	uint32_t mask;
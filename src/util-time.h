@@ -131,6 +131,20 @@ now_in_us(uint64_t *us)
 	return 0;
 }
 
+static inline int
+now_in_ns(uint64_t *ns)
+{
+	struct timespec ts = { 0, 0 };
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+		*ns = 0;
+		return -errno;
+	}
+
+	*ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	return 0;
+}
+
 struct human_time {
 	unsigned int value;
 	const char *unit;
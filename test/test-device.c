@@ -572,6 +572,44 @@ START_TEST(device_disable_release_keys)
 }
 END_TEST
 
+START_TEST(device_disable_reenable_keys)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_device *device;
+	enum libinput_config_status status;
+
+	device = dev->libinput_device;
+
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_drain_events(li);
+
+	status = libinput_device_config_send_events_set_mode(
+		device,
+		LIBINPUT_CONFIG_SEND_EVENTS_DISABLED);
+	litest_assert_enum_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_RELEASED);
+
+	/* Released while disabled, we never see this */
+	litest_keyboard_key(dev, KEY_A, false);
+
+	status = libinput_device_config_send_events_set_mode(
+		device,
+		LIBINPUT_CONFIG_SEND_EVENTS_ENABLED);
+	litest_assert_enum_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	litest_drain_events(li);
+
+	/* The key was released when the device was disabled, pressing it
+	 * again must be a new press */
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_PRESSED);
+	litest_keyboard_key(dev, KEY_A, false);
+	litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_RELEASED);
+
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
 START_TEST(device_disable_release_tap)
 {
 	struct litest_device *dev = litest_current_device();
@@ -1594,6 +1632,42 @@ START_TEST(device_seat_phys_name)
 }
 END_TEST
 
+START_TEST(device_seat_dispatch)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_seat *seat = libinput_device_get_seat(dev->libinput_device);
+	struct libinput_event *event;
+	int fd;
+
+	litest_drain_events(li);
+
+	litest_set_log_handler_bug(li);
+	litest_assert_int_eq(libinput_seat_dispatch(seat), -EINVAL);
+	litest_restore_log_handler(li);
+	litest_assert(libinput_seat_get_event(seat) == NULL);
+
+	fd = libinput_seat_get_fd(seat);
+	litest_assert_int_ge(fd, 0);
+	litest_assert_int_ne(fd, libinput_get_fd(li));
+	litest_assert_int_eq(libinput_seat_get_fd(seat), fd);
+
+	litest_event(dev, EV_REL, REL_X, 5);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+
+	/* The seat's devices are no longer dispatched by the context */
+	litest_dispatch(li);
+	litest_assert_empty_queue(li);
+
+	litest_assert_int_eq(libinput_seat_dispatch(seat), 0);
+	event = libinput_seat_get_event(seat);
+	litest_assert_notnull(event);
+	litest_assert_event_type(event, LIBINPUT_EVENT_POINTER_MOTION);
+	libinput_event_destroy(event);
+	litest_assert(libinput_seat_get_event(seat) == NULL);
+}
+END_TEST
+
 START_TEST(device_button_down_remove)
 {
 	struct litest_device *lidev = litest_current_device();
@@ -1681,6 +1755,7 @@ TEST_COLLECTION(device)
 	litest_add_no_device(device_reenable_device_removed);
 	litest_add_for_device(device_disable_release_buttons, LITEST_MOUSE);
 	litest_add_for_device(device_disable_release_keys, LITEST_KEYBOARD);
+	litest_add_for_device(device_disable_reenable_keys, LITEST_KEYBOARD);
 	litest_add(device_disable_release_tap, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add(device_disable_release_tap_n_drag, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add(device_disable_release_softbutton, LITEST_CLICKPAD, LITEST_APPLE_CLICKPAD);
@@ -1741,6 +1816,7 @@ TEST_COLLECTION(device)
 	litest_add(device_no_output, LITEST_KEYS, LITEST_ANY);
 
 	litest_add(device_seat_phys_name, LITEST_ANY, LITEST_ANY);
+	litest_add_for_device(device_seat_dispatch, LITEST_MOUSE);
 
 	litest_add(device_button_down_remove, LITEST_BUTTON, LITEST_ANY);
 
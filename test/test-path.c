@@ -447,6 +447,67 @@ START_TEST(path_add_invalid_path)
 }
 END_TEST
 
+START_TEST(path_seat_fd_replug)
+{
+	struct libinput *li;
+	struct libinput_device *device;
+	struct libinput_seat *seat;
+	struct libinput_event *event;
+	struct libevdev_uinput *uinput;
+	int fd;
+
+	/* clang-format off */
+	uinput = litest_create_uinput_device("test device", NULL,
+					      EV_KEY, BTN_LEFT,
+					      EV_KEY, BTN_RIGHT,
+					      EV_REL, REL_X,
+					      EV_REL, REL_Y,
+					      -1);
+	/* clang-format on */
+
+	li = litest_create_context();
+	device = libinput_path_add_device(li, libevdev_uinput_get_devnode(uinput));
+	litest_assert_notnull(device);
+	seat = libinput_device_get_seat(device);
+	litest_drain_events(li);
+
+	fd = libinput_seat_get_fd(seat);
+	litest_assert_int_ge(fd, 0);
+
+	/* Removing the seat's only device must not destroy the seat */
+	libinput_path_remove_device(device);
+	litest_dispatch(li);
+	litest_assert_empty_queue(li);
+	event = libinput_seat_get_event(seat);
+	litest_assert_event_type(event, LIBINPUT_EVENT_DEVICE_REMOVED);
+	libinput_event_destroy(event);
+
+	device = libinput_path_add_device(li, libevdev_uinput_get_devnode(uinput));
+	litest_assert_notnull(device);
+	litest_assert_ptr_eq(libinput_device_get_seat(device), seat);
+	litest_assert_int_eq(libinput_seat_get_fd(seat), fd);
+
+	litest_dispatch(li);
+	litest_assert_empty_queue(li);
+	event = libinput_seat_get_event(seat);
+	litest_assert_event_type(event, LIBINPUT_EVENT_DEVICE_ADDED);
+	libinput_event_destroy(event);
+
+	/* The replugged device is dispatched from the seat's fd */
+	libevdev_uinput_write_event(uinput, EV_REL, REL_X, 5);
+	libevdev_uinput_write_event(uinput, EV_SYN, SYN_REPORT, 0);
+	litest_dispatch(li);
+	litest_assert_empty_queue(li);
+	litest_assert_int_eq(libinput_seat_dispatch(seat), 0);
+	event = libinput_seat_get_event(seat);
+	litest_assert_event_type(event, LIBINPUT_EVENT_POINTER_MOTION);
+	libinput_event_destroy(event);
+
+	litest_destroy_context(li);
+	libevdev_uinput_destroy(uinput);
+}
+END_TEST
+
 START_TEST(path_device_sysname)
 {
 	struct litest_device *dev = litest_current_device();
@@ -1026,6 +1087,7 @@ TEST_COLLECTION(path)
 	litest_add(path_device_sysname, LITEST_ANY, LITEST_ANY);
 	litest_add_for_device(path_add_device, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_no_device(path_add_invalid_path);
+	litest_add_no_device(path_seat_fd_replug);
 	litest_add_for_device(path_remove_device, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_for_device(path_double_remove_device, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_no_device(path_device_gone);
@@ -2645,6 +2645,152 @@ START_TEST(pointer_accel_profile_flat_motion_relative)
 }
 END_TEST
 
+START_TEST(pointer_accel_profile_flat_speed)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput *li = dev->libinput;
+	enum libinput_config_status status;
+	double speeds[] = { -0.5, 0.0, 0.5, 1.0 };
+
+	status = libinput_device_config_accel_set_profile(
+		device,
+		LIBINPUT_CONFIG_ACCEL_PROFILE_FLAT);
+	litest_assert_enum_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	litest_drain_events(li);
+
+	ARRAY_FOR_EACH(speeds, speed) {
+		status = libinput_device_config_accel_set_speed(device, *speed);
+		litest_assert_enum_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+		litest_event(dev, EV_REL, REL_X, 10);
+		litest_event(dev, EV_REL, REL_Y, -4);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		litest_dispatch(li);
+
+		_destroy_(libinput_event) *event = libinput_get_event(li);
+		struct libinput_event_pointer *ptrev = litest_is_motion_event(event);
+
+		/* flat mouse profile is a plain factor of 1 + speed */
+		litest_assert_double_eq_epsilon(libinput_event_pointer_get_dx(ptrev),
+						10 * (1 + *speed),
+						0.0001);
+		litest_assert_double_eq_epsilon(libinput_event_pointer_get_dy(ptrev),
+						-4 * (1 + *speed),
+						0.0001);
+		litest_assert_double_eq(
+			libinput_event_pointer_get_dx_unaccelerated(ptrev),
+			10.0);
+	}
+}
+END_TEST
+
+START_TEST(pointer_accel_profile_flat_speed_touchpad)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput *li = dev->libinput;
+	enum libinput_config_status status;
+	double speeds[] = { -1.0, -0.5, 0.0, 0.5, 1.0 };
+
+	status = libinput_device_config_accel_set_profile(
+		device,
+		LIBINPUT_CONFIG_ACCEL_PROFILE_FLAT);
+	litest_assert_enum_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	litest_disable_tap(device);
+	litest_disable_hold_gestures(device);
+	litest_drain_events(li);
+
+	ARRAY_FOR_EACH(speeds, speed) {
+		unsigned int nevents = 0;
+
+		status = libinput_device_config_accel_set_speed(device, *speed);
+		litest_assert_enum_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+		litest_touch_down(dev, 0, 40, 40);
+		litest_touch_move_to(dev, 0, 40, 40, 60, 50, 10);
+		litest_touch_up(dev, 0);
+		litest_dispatch(li);
+
+		while (libinput_next_event_type(li) != LIBINPUT_EVENT_NONE) {
+			_destroy_(libinput_event) *event = libinput_get_event(li);
+			if (libinput_event_get_type(event) !=
+			    LIBINPUT_EVENT_POINTER_MOTION)
+				continue;
+
+			struct libinput_event_pointer *ptrev =
+				libinput_event_get_pointer_event(event);
+			double dx = libinput_event_pointer_get_dx_unaccelerated(ptrev);
+			double dy = libinput_event_pointer_get_dy_unaccelerated(ptrev);
+
+			/* flat touchpad profile is the touchpad slowdown of
+			 * 0.2968 times max(0.005, 1 + speed), with the
+			 * device units normalized to 1000dpi. litest
+			 * touchpads have the default dpi. */
+			double factor = 0.2968 * max(0.005, 1 + *speed);
+
+			litest_assert_double_eq_epsilon(
+				libinput_event_pointer_get_dx(ptrev),
+				dx * factor,
+				0.0001);
+			litest_assert_double_eq_epsilon(
+				libinput_event_pointer_get_dy(ptrev),
+				dy * factor,
+				0.0001);
+			nevents++;
+		}
+
+		litest_assert_int_gt(nevents, 0U);
+	}
+}
+END_TEST
+
+START_TEST(pointer_accel_profile_flat_speed_trackpoint)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput *li = dev->libinput;
+	enum libinput_config_status status;
+	double speeds[] = { -1.0, -0.5, 0.0, 0.5, 1.0 };
+
+	status = libinput_device_config_accel_set_profile(
+		device,
+		LIBINPUT_CONFIG_ACCEL_PROFILE_FLAT);
+	litest_assert_enum_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	litest_drain_events(li);
+
+	ARRAY_FOR_EACH(speeds, speed) {
+		status = libinput_device_config_accel_set_speed(device, *speed);
+		litest_assert_enum_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+		litest_event(dev, EV_REL, REL_X, 10);
+		litest_event(dev, EV_REL, REL_Y, -4);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		litest_dispatch(li);
+
+		_destroy_(libinput_event) *event = libinput_get_event(li);
+		struct libinput_event_pointer *ptrev = litest_is_motion_event(event);
+
+		/* flat trackpoint profile is the speed curve from
+		 * filter-trackpoint-flat.c times the trackpoint multiplier,
+		 * the litest trackpoint has a multiplier of 1.0 */
+		double s = 1 + *speed;
+		double factor = 435837.2 + (0.04762636 - 435837.2) /
+						   (1 + pow(s / 240.4549, 2.377168));
+
+		litest_assert_double_eq_epsilon(libinput_event_pointer_get_dx(ptrev),
+						10 * factor,
+						0.0001);
+		litest_assert_double_eq_epsilon(libinput_event_pointer_get_dy(ptrev),
+						-4 * factor,
+						0.0001);
+		litest_assert_double_eq(
+			libinput_event_pointer_get_dx_unaccelerated(ptrev),
+			10.0);
+	}
+}
+END_TEST
+
 START_TEST(middlebutton)
 {
 	struct litest_device *device = litest_current_device();
@@ -3849,6 +3995,9 @@ TEST_COLLECTION(pointer)
 	litest_add(pointer_accel_profile_invalid, LITEST_RELATIVE, LITEST_ANY);
 	litest_add(pointer_accel_profile_noaccel, LITEST_ANY, LITEST_TOUCHPAD|LITEST_RELATIVE|LITEST_TABLET);
 	litest_add(pointer_accel_profile_flat_motion_relative, LITEST_RELATIVE, LITEST_TOUCHPAD);
+	litest_add(pointer_accel_profile_flat_speed, LITEST_RELATIVE, LITEST_TOUCHPAD|LITEST_POINTINGSTICK);
+	litest_add(pointer_accel_profile_flat_speed_touchpad, LITEST_TOUCHPAD, LITEST_ANY);
+	litest_add_for_device(pointer_accel_profile_flat_speed_trackpoint, LITEST_TRACKPOINT);
 
 	litest_add(middlebutton, LITEST_BUTTON, LITEST_CLICKPAD);
 	litest_add(middlebutton_nostart_while_down, LITEST_BUTTON, LITEST_CLICKPAD);
@@ -79,6 +79,8 @@ data_dir_destroy(struct data_dir *dd)
 		free(dd->filename);
 	}
 	if (dd->dirname) {
+		_autofree_ char *image = strdup_printf("%s/quirks.bin", dd->dirname);
+		unlink(image);
 		rmdir(dd->dirname);
 		free(dd->dirname);
 	}
@@ -1532,6 +1534,400 @@ START_TEST(quirks_ctx_ref)
 }
 END_TEST
 
+START_TEST(quirks_fetch_cached)
+{
+	struct litest_device *dev = litest_current_device();
+	_unref_(udev_device) *ud =
+		libinput_device_get_udev_device(dev->libinput_device);
+	const char quirks_file[] =
+		"[Section name]\n"
+		"MatchUdevType=mouse\n"
+		"AttrSizeHint=10x10\n";
+	_destroy_(data_dir) *dd = data_dir_new(quirks_file);
+
+	_unref_(quirks_context) *ctx =
+		quirks_init_subsystem(dd->dirname,
+				      NULL,
+				      log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx);
+
+	_unref_(quirks) *q1 = quirks_fetch_for_device(ctx, ud);
+	litest_assert_notnull(q1);
+	_unref_(quirks) *q2 = quirks_fetch_for_device(ctx, ud);
+	litest_assert_ptr_eq(q1, q2);
+
+	/* A new context has its own cache */
+	_unref_(quirks_context) *ctx2 =
+		quirks_init_subsystem(dd->dirname,
+				      NULL,
+				      log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx2);
+
+	_unref_(quirks) *q3 = quirks_fetch_for_device(ctx2, ud);
+	litest_assert_notnull(q3);
+	litest_assert_ptr_ne(q1, q3);
+
+	struct quirk_dimensions dim;
+	litest_assert(quirks_get_dimensions(q2, QUIRK_ATTR_SIZE_HINT, &dim));
+	litest_assert_int_eq(dim.x, 10U);
+	litest_assert_int_eq(dim.y, 10U);
+}
+END_TEST
+
+START_TEST(quirks_fetch_cached_none)
+{
+	struct litest_device *dev = litest_current_device();
+	_unref_(udev_device) *ud =
+		libinput_device_get_udev_device(dev->libinput_device);
+	const char quirks_file[] =
+		"[Section name]\n"
+		"MatchUdevType=touchpad\n"
+		"AttrSizeHint=10x10\n";
+	_destroy_(data_dir) *dd = data_dir_new(quirks_file);
+
+	_unref_(quirks_context) *ctx =
+		quirks_init_subsystem(dd->dirname,
+				      NULL,
+				      log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx);
+
+	/* Devices without quirks are cached too, but still return NULL */
+	for (int i = 0; i < 3; i++) {
+		_unref_(quirks) *q = quirks_fetch_for_device(ctx, ud);
+		litest_assert_ptr_null(q);
+	}
+}
+END_TEST
+
+START_TEST(quirks_attr_override)
+{
+	struct litest_device *dev = litest_current_device();
+	_unref_(udev_device) *ud =
+		libinput_device_get_udev_device(dev->libinput_device);
+	/* Each quirk takes the value from the last section that sets it,
+	 * AttrEventCode accumulates across sections */
+	const char quirks_file[] =
+		"[first]\n"
+		"MatchUdevType=mouse\n"
+		"AttrSizeHint=10x10\n"
+		"AttrPalmSizeThreshold=1\n"
+		"AttrEventCode=-BTN_RIGHT\n"
+		"ModelAppleTouchpad=1\n"
+		"\n"
+		"[second]\n"
+		"MatchUdevType=mouse\n"
+		"AttrSizeHint=20x20\n"
+		"AttrEventCode=+BTN_MIDDLE\n"
+		"\n"
+		"[third]\n"
+		"MatchUdevType=mouse\n"
+		"AttrPalmSizeThreshold=3\n"
+		"ModelAppleTouchpad=0\n";
+	_destroy_(data_dir) *dd = data_dir_new(quirks_file);
+
+	_unref_(quirks_context) *ctx =
+		quirks_init_subsystem(dd->dirname,
+				      NULL,
+				      log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx);
+
+	_unref_(quirks) *q = quirks_fetch_for_device(ctx, ud);
+	litest_assert_notnull(q);
+
+	struct quirk_dimensions dim;
+	litest_assert(quirks_get_dimensions(q, QUIRK_ATTR_SIZE_HINT, &dim));
+	litest_assert_int_eq(dim.x, 20U);
+	litest_assert_int_eq(dim.y, 20U);
+
+	uint32_t threshold;
+	litest_assert(quirks_get_uint32(q, QUIRK_ATTR_PALM_SIZE_THRESHOLD, &threshold));
+	litest_assert_int_eq(threshold, 3U);
+
+	bool isset;
+	litest_assert(quirks_get_bool(q, QUIRK_MODEL_APPLE_TOUCHPAD, &isset));
+	litest_assert(!isset);
+
+	const struct quirk_tuples *t;
+	litest_assert(quirks_get_tuples(q, QUIRK_ATTR_EVENT_CODE, &t));
+	litest_assert_int_eq(t->ntuples, 2U);
+	litest_assert_int_eq(t->tuples[0].second, BTN_RIGHT);
+	litest_assert_int_eq(t->tuples[0].third, 0);
+	litest_assert_int_eq(t->tuples[1].second, BTN_MIDDLE);
+	litest_assert_int_eq(t->tuples[1].third, 1);
+
+	litest_assert(!quirks_has_quirk(q, QUIRK_ATTR_PALM_PRESSURE_THRESHOLD));
+	litest_assert(!quirks_has_quirk(q, QUIRK_MODEL_WACOM_TOUCHPAD));
+}
+END_TEST
+
+START_TEST(quirks_match_order_indexed)
+{
+	struct litest_device *dev = litest_current_device();
+	_unref_(udev_device) *ud =
+		libinput_device_get_udev_device(dev->libinput_device);
+	/* Sections matching on vendor/product are looked up in an index,
+	 * the others are not, the order must be the same as in the file */
+	const char quirks_file[] =
+		"[residual]\n"
+		"MatchUdevType=mouse\n"
+		"AttrSizeHint=10x10\n"
+		"AttrPalmSizeThreshold=1\n"
+		"\n"
+		"[indexed]\n"
+		"MatchVendor=0x17EF\n"
+		"MatchProduct=0x1234;0x6019\n"
+		"AttrSizeHint=20x20\n"
+		"AttrPalmSizeThreshold=2\n"
+		"\n"
+		"[indexed any product]\n"
+		"MatchVendor=0x17EF\n"
+		"AttrPalmSizeThreshold=3\n"
+		"\n"
+		"[other product]\n"
+		"MatchVendor=0x17EF\n"
+		"MatchProduct=0x1234\n"
+		"AttrPalmSizeThreshold=4\n"
+		"\n"
+		"[residual again]\n"
+		"MatchUdevType=mouse\n"
+		"AttrSizeHint=30x30\n"
+		"\n"
+		"[other system]\n"
+		"MatchUdevType=mouse\n"
+		"MatchDMIModalias=dmi:*svnNoSuchVendor:*\n"
+		"AttrSizeHint=40x40\n";
+	_destroy_(data_dir) *dd = data_dir_new(quirks_file);
+
+	_unref_(quirks_context) *ctx =
+		quirks_init_subsystem(dd->dirname,
+				      NULL,
+				      log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx);
+
+	_unref_(quirks) *q = quirks_fetch_for_device(ctx, ud);
+	litest_assert_notnull(q);
+
+	struct quirk_dimensions dim;
+	litest_assert(quirks_get_dimensions(q, QUIRK_ATTR_SIZE_HINT, &dim));
+	litest_assert_int_eq(dim.x, 30U);
+	litest_assert_int_eq(dim.y, 30U);
+
+	uint32_t threshold;
+	litest_assert(quirks_get_uint32(q, QUIRK_ATTR_PALM_SIZE_THRESHOLD, &threshold));
+	litest_assert_int_eq(threshold, 3U);
+}
+END_TEST
+
+static bool image_loaded;
+
+static void
+image_log_handler(struct libinput *this_is_null,
+		  enum libinput_log_priority priority,
+		  const char *format,
+		  va_list args)
+{
+	if (strstr(format, "loaded %u sections"))
+		image_loaded = true;
+}
+
+START_TEST(quirks_compiled_image)
+{
+	struct litest_device *dev = litest_current_device();
+	_unref_(udev_device) *ud =
+		libinput_device_get_udev_device(dev->libinput_device);
+	const char quirks_file[] =
+		"[first]\n"
+		"MatchUdevType=mouse\n"
+		"ModelAppleTouchpad=1\n"
+		"AttrSizeHint=10x20\n"
+		"AttrEventCode=-BTN_RIGHT\n"
+		"\n"
+		"[second]\n"
+		"MatchName=*Optical*\n"
+		"MatchBus=usb\n"
+		"MatchVendor=0x17EF\n"
+		"MatchProduct=0x6019\n"
+		"AttrPressureRange=10:8\n"
+		"AttrTrackpointMultiplier=1.5\n"
+		"AttrLidSwitchReliability=write_open\n"
+		"\n"
+		"[third]\n"
+		"MatchName=*does not match*\n"
+		"AttrSizeHint=30x40\n";
+	_destroy_(data_dir) *dd = data_dir_new(quirks_file);
+
+	_unref_(quirks_context) *ctx =
+		quirks_init_subsystem(dd->dirname,
+				      NULL,
+				      log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx);
+	litest_assert(quirks_context_compile(ctx));
+
+	image_loaded = false;
+	_unref_(quirks_context) *compiled =
+		quirks_init_subsystem(dd->dirname,
+				      NULL,
+				      image_log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(compiled);
+	litest_assert(image_loaded);
+
+	_unref_(quirks) *q = quirks_fetch_for_device(compiled, ud);
+	litest_assert_notnull(q);
+
+	bool b;
+	litest_assert(quirks_get_bool(q, QUIRK_MODEL_APPLE_TOUCHPAD, &b));
+	litest_assert(b);
+
+	struct quirk_dimensions dim;
+	litest_assert(quirks_get_dimensions(q, QUIRK_ATTR_SIZE_HINT, &dim));
+	litest_assert_int_eq(dim.x, 10U);
+	litest_assert_int_eq(dim.y, 20U);
+
+	const struct quirk_tuples *t;
+	litest_assert(quirks_get_tuples(q, QUIRK_ATTR_EVENT_CODE, &t));
+	litest_assert_int_eq(t->ntuples, 1U);
+	litest_assert_int_eq(t->tuples[0].first, EV_KEY);
+	litest_assert_int_eq(t->tuples[0].second, BTN_RIGHT);
+	litest_assert_int_eq(t->tuples[0].third, 0);
+
+	struct quirk_range r;
+	litest_assert(quirks_get_range(q, QUIRK_ATTR_PRESSURE_RANGE, &r));
+	litest_assert_int_eq(r.upper, 10);
+	litest_assert_int_eq(r.lower, 8);
+
+	double d;
+	litest_assert(quirks_get_double(q, QUIRK_ATTR_TRACKPOINT_MULTIPLIER, &d));
+	litest_assert_double_eq(d, 1.5);
+
+	char *str;
+	litest_assert(quirks_get_string(q, QUIRK_ATTR_LID_SWITCH_RELIABILITY, &str));
+	litest_assert_str_eq(str, "write_open");
+}
+END_TEST
+
+START_TEST(quirks_compiled_image_override)
+{
+	struct litest_device *dev = litest_current_device();
+	_unref_(udev_device) *ud =
+		libinput_device_get_udev_device(dev->libinput_device);
+	const char quirks_file[] =
+		"[Section name]\n"
+		"MatchUdevType=mouse\n"
+		"AttrSizeHint=10x20\n";
+	const char override_file[] =
+		"[Override]\n"
+		"MatchUdevType=mouse\n"
+		"AttrSizeHint=30x40\n";
+	_destroy_(data_dir) *dd = data_dir_new(quirks_file);
+	_destroy_(data_dir) *od = data_dir_new(override_file);
+	struct quirk_dimensions dim;
+
+	/* The override file is not compiled into the image */
+	_unref_(quirks_context) *ctx =
+		quirks_init_subsystem(dd->dirname,
+				      od->filename,
+				      log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx);
+	litest_assert(quirks_context_compile(ctx));
+
+	image_loaded = false;
+	_unref_(quirks_context) *no_override =
+		quirks_init_subsystem(dd->dirname,
+				      NULL,
+				      image_log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(no_override);
+	litest_assert(image_loaded);
+
+	_unref_(quirks) *q1 = quirks_fetch_for_device(no_override, ud);
+	litest_assert(quirks_get_dimensions(q1, QUIRK_ATTR_SIZE_HINT, &dim));
+	litest_assert_int_eq(dim.x, 10U);
+	litest_assert_int_eq(dim.y, 20U);
+
+	/* An override file doesn't invalidate the image, it applies on top */
+	image_loaded = false;
+	_unref_(quirks_context) *with_override =
+		quirks_init_subsystem(dd->dirname,
+				      od->filename,
+				      image_log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(with_override);
+	litest_assert(image_loaded);
+
+	_unref_(quirks) *q2 = quirks_fetch_for_device(with_override, ud);
+	litest_assert(quirks_get_dimensions(q2, QUIRK_ATTR_SIZE_HINT, &dim));
+	litest_assert_int_eq(dim.x, 30U);
+	litest_assert_int_eq(dim.y, 40U);
+}
+END_TEST
+
+START_TEST(quirks_compiled_image_stale)
+{
+	struct litest_device *dev = litest_current_device();
+	_unref_(udev_device) *ud =
+		libinput_device_get_udev_device(dev->libinput_device);
+	const char quirks_file[] =
+		"[Section name]\n"
+		"MatchUdevType=mouse\n"
+		"AttrSizeHint=10x20\n";
+	_destroy_(data_dir) *dd = data_dir_new(quirks_file);
+
+	_unref_(quirks_context) *ctx =
+		quirks_init_subsystem(dd->dirname,
+				      NULL,
+				      log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx);
+	litest_assert(quirks_context_compile(ctx));
+
+	{
+		_autofclose_ FILE *fp = fopen(dd->filename, "w");
+		litest_assert_notnull(fp);
+		fputs("[Section name]\n"
+		      "MatchUdevType=mouse\n"
+		      "AttrSizeHint=30x40\n",
+		      fp);
+	}
+
+	image_loaded = false;
+	_unref_(quirks_context) *reloaded =
+		quirks_init_subsystem(dd->dirname,
+				      NULL,
+				      image_log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(reloaded);
+	litest_assert(!image_loaded);
+
+	_unref_(quirks) *q = quirks_fetch_for_device(reloaded, ud);
+	litest_assert_notnull(q);
+
+	struct quirk_dimensions dim;
+	litest_assert(quirks_get_dimensions(q, QUIRK_ATTR_SIZE_HINT, &dim));
+	litest_assert_int_eq(dim.x, 30U);
+	litest_assert_int_eq(dim.y, 40U);
+}
+END_TEST
+
 TEST_COLLECTION(quirks)
 {
 	/* clang-format off */
@@ -1597,5 +1993,13 @@ TEST_COLLECTION(quirks)
 
 	litest_add_deviceless(quirks_call_NULL);
 	litest_add_deviceless(quirks_ctx_ref);
+
+	litest_add_for_device(quirks_fetch_cached, LITEST_MOUSE);
+	litest_add_for_device(quirks_fetch_cached_none, LITEST_MOUSE);
+	litest_add_for_device(quirks_attr_override, LITEST_MOUSE);
+	litest_add_for_device(quirks_match_order_indexed, LITEST_MOUSE);
+	litest_add_for_device(quirks_compiled_image, LITEST_MOUSE);
+	litest_add_for_device(quirks_compiled_image_stale, LITEST_MOUSE);
+	litest_add_for_device(quirks_compiled_image_override, LITEST_MOUSE);
 	/* clang-format on */
 }
@@ -1761,6 +1761,102 @@ START_TEST(motion)
 }
 END_TEST
 
+START_TEST(axis_coalescing_config)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	enum libinput_config_status status;
+
+	litest_assert(libinput_device_config_axis_coalescing_is_available(device));
+	litest_assert_enum_eq(
+		libinput_device_config_axis_coalescing_get_default_enabled(device),
+		LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED);
+	litest_assert_enum_eq(libinput_device_config_axis_coalescing_get_enabled(device),
+			      LIBINPUT_CONFIG_AXIS_COALESCING_DISABLED);
+
+	status = libinput_device_config_axis_coalescing_set_enabled(
+		device,
+		LIBINPUT_CONFIG_AXIS_COALESCING_ENABLED);
+	litest_assert_enum_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	litest_assert_enum_eq(libinput_device_config_axis_coalescing_get_enabled(device),
+			      LIBINPUT_CONFIG_AXIS_COALESCING_ENABLED);
+
+	status = libinput_device_config_axis_coalescing_set_enabled(device, 3);
+	litest_assert_enum_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+}
+END_TEST
+
+START_TEST(axis_coalescing)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event_tablet_tool *tev;
+	struct axis_replacement axes[] = {
+		{ ABS_DISTANCE, 10 },
+		{ ABS_PRESSURE, 0 },
+		{ -1, -1 },
+	};
+	bool enabled = litest_test_param_get_bool(test_env->params, "enabled");
+	unsigned int nsamples = 0;
+	unsigned int nevents = 0;
+	unsigned int max_count = 0;
+	double last_x = 0.0;
+
+	if (enabled)
+		libinput_device_config_axis_coalescing_set_enabled(
+			dev->libinput_device,
+			LIBINPUT_CONFIG_AXIS_COALESCING_ENABLED);
+
+	litest_tablet_proximity_in(dev, 10, 10, axes);
+	litest_drain_events(li);
+
+	for (int x = 20; x <= 60; x += 10)
+		litest_tablet_motion(dev, x, 10, axes);
+	litest_dispatch(li);
+
+	/* With coalescing, the five frames are merged into fewer events
+	 * but the samples of all events together must cover every frame */
+	while (libinput_next_event_type(li) != LIBINPUT_EVENT_NONE) {
+		_destroy_(libinput_event) *event = libinput_get_event(li);
+		if (libinput_event_get_type(event) != LIBINPUT_EVENT_TABLET_TOOL_AXIS)
+			continue;
+
+		tev = libinput_event_get_tablet_tool_event(event);
+		unsigned int count = libinput_event_tablet_tool_get_sample_count(tev);
+		uint64_t last_time = 0;
+
+		if (!enabled)
+			litest_assert_int_eq(count, 1U);
+
+		for (unsigned int i = 0; i < count; i++) {
+			double x = libinput_event_tablet_tool_get_sample_x(tev, i);
+			uint64_t time =
+				libinput_event_tablet_tool_get_sample_time_usec(tev, i);
+
+			litest_assert_double_gt(x, last_x);
+			litest_assert_int_ge(time, last_time);
+			last_x = x;
+			last_time = time;
+		}
+
+		litest_assert_double_eq(libinput_event_tablet_tool_get_x(tev), last_x);
+		litest_assert_int_eq(libinput_event_tablet_tool_get_time_usec(tev),
+				     last_time);
+		nsamples += count;
+		nevents++;
+		max_count = max(max_count, count);
+	}
+
+	litest_assert_int_eq(nsamples, 5U);
+	if (enabled) {
+		litest_assert_int_lt(nevents, 5U);
+		litest_assert_int_gt(max_count, 1U);
+	} else {
+		litest_assert_int_eq(nevents, 5U);
+	}
+}
+END_TEST
+
 START_TEST(left_handed)
 {
 #ifdef HAVE_LIBWACOM
@@ -2078,6 +2174,52 @@ START_TEST(left_handed_artpen_rotation)
 }
 END_TEST
 
+START_TEST(axis_coalescing_max_samples)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct axis_replacement axes[] = {
+		{ ABS_DISTANCE, 10 },
+		{ ABS_PRESSURE, 0 },
+		{ -1, -1 },
+	};
+	unsigned int nsamples = 0;
+	unsigned int nevents = 0;
+
+	libinput_device_config_axis_coalescing_set_enabled(
+		dev->libinput_device,
+		LIBINPUT_CONFIG_AXIS_COALESCING_ENABLED);
+
+	litest_tablet_proximity_in(dev, 10, 10, axes);
+	litest_drain_events(li);
+
+	/* The queue isn't drained between dispatches, so every frame
+	 * would coalesce into the same event without a cap */
+	for (int i = 0; i < 100; i++) {
+		litest_tablet_motion(dev, 10 + i * 0.8, 10, axes);
+		if (i % 10 == 9)
+			litest_dispatch(li);
+	}
+
+	while (libinput_next_event_type(li) != LIBINPUT_EVENT_NONE) {
+		_destroy_(libinput_event) *event = libinput_get_event(li);
+		if (libinput_event_get_type(event) != LIBINPUT_EVENT_TABLET_TOOL_AXIS)
+			continue;
+
+		struct libinput_event_tablet_tool *tev =
+			libinput_event_get_tablet_tool_event(event);
+		unsigned int count = libinput_event_tablet_tool_get_sample_count(tev);
+
+		litest_assert_int_le(count, 64U);
+		nsamples += count;
+		nevents++;
+	}
+
+	litest_assert_int_eq(nsamples, 100U);
+	litest_assert_int_ge(nevents, 2U);
+}
+END_TEST
+
 START_TEST(motion_event_state)
 {
 	struct litest_device *dev = litest_current_device();
@@ -7478,6 +7620,11 @@ TEST_COLLECTION(tablet)
 	litest_add(button_seat_count, LITEST_TABLET, LITEST_ANY);
 	litest_add_no_device(button_up_on_delete);
 	litest_add(motion, LITEST_TABLET, LITEST_ANY);
+	litest_add(axis_coalescing_config, LITEST_TABLET, LITEST_TOTEM);
+	litest_with_parameters(params, "enabled", 'b') {
+		litest_add_parametrized(axis_coalescing, LITEST_TABLET, LITEST_TOTEM, params);
+	}
+	litest_add(axis_coalescing_max_samples, LITEST_TABLET, LITEST_TOTEM);
 	litest_add(motion_event_state, LITEST_TABLET, LITEST_ANY);
 	litest_add_for_device(motion_outside_bounds, LITEST_WACOM_CINTIQ_24HD_PEN);
 	litest_add(tilt_available, LITEST_TABLET|LITEST_TILT, LITEST_ANY);
@@ -1269,6 +1269,78 @@ START_TEST(touchpad_palm_detect_at_edge)
 }
 END_TEST
 
+struct palm_stats {
+	unsigned int nchecks;
+	uint64_t edge_evaluated;
+	uint64_t edge_triggered;
+};
+
+static void
+palm_stats_collect(struct libinput_device *device,
+		   const char *check,
+		   uint64_t evaluated,
+		   uint64_t triggered,
+		   uint64_t time_nsec,
+		   void *user_data)
+{
+	struct palm_stats *stats = user_data;
+
+	litest_assert_int_le(triggered, evaluated);
+
+	stats->nchecks++;
+	if (streq(check, "edge")) {
+		stats->edge_evaluated = evaluated;
+		stats->edge_triggered = triggered;
+	}
+}
+
+START_TEST(touchpad_palm_stats)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct palm_stats stats = { 0 };
+
+	if (!litest_has_palm_detect_size(dev) || !litest_has_2fg_scroll(dev))
+		return LITEST_NOT_APPLICABLE;
+
+	litest_enable_2fg_scroll(dev);
+
+	litest_disable_tap(dev->libinput_device);
+	litest_disable_hold_gestures(dev->libinput_device);
+	litest_drain_events(li);
+
+	libinput_device_palm_stats_dump(dev->libinput_device,
+					palm_stats_collect,
+					&stats);
+	litest_assert_int_gt(stats.nchecks, 0U);
+	litest_assert_int_eq(stats.edge_triggered, 0U);
+
+	litest_touch_down(dev, 0, 5, 50);
+	litest_touch_move_to(dev, 0, 5, 50, 5, 70, 5);
+	litest_touch_up(dev, 0);
+	litest_assert_empty_queue(li);
+
+	stats = (struct palm_stats){ 0 };
+	libinput_device_palm_stats_dump(dev->libinput_device,
+					palm_stats_collect,
+					&stats);
+	litest_assert_int_gt(stats.edge_evaluated, 0U);
+	litest_assert_int_eq(stats.edge_triggered, 1U);
+}
+END_TEST
+
+START_TEST(touchpad_palm_stats_not_touchpad)
+{
+	struct litest_device *dev = litest_current_device();
+	struct palm_stats stats = { 0 };
+
+	libinput_device_palm_stats_dump(dev->libinput_device,
+					palm_stats_collect,
+					&stats);
+	litest_assert_int_eq(stats.nchecks, 0U);
+}
+END_TEST
+
 START_TEST(touchpad_palm_detect_at_top)
 {
 	struct litest_device *dev = litest_current_device();
@@ -7210,6 +7282,8 @@ TEST_COLLECTION(touchpad_palm)
 {
 	/* clang-format off */
 	litest_add(touchpad_palm_detect_at_edge, LITEST_TOUCHPAD, LITEST_ANY);
+	litest_add(touchpad_palm_stats, LITEST_TOUCHPAD, LITEST_ANY);
+	litest_add(touchpad_palm_stats_not_touchpad, LITEST_ANY, LITEST_TOUCHPAD);
 	litest_add(touchpad_palm_detect_at_top, LITEST_TOUCHPAD, LITEST_TOPBUTTONPAD);
 	litest_add(touchpad_palm_detect_at_bottom_corners, LITEST_TOUCHPAD, LITEST_CLICKPAD);
 	litest_add(touchpad_palm_detect_at_top_corners, LITEST_TOUCHPAD, LITEST_TOPBUTTONPAD);
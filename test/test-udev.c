@@ -511,6 +511,203 @@ START_TEST(udev_seat_recycle)
 }
 END_TEST
 
+START_TEST(udev_enumerate_devices)
+{
+	/* Devices present at assign_seat time must be added exactly once
+	 * and in the order udev enumerates them */
+	enum litest_device_type types[] = {
+		LITEST_MOUSE,
+		LITEST_KEYBOARD,
+		LITEST_TRACKPOINT,
+		LITEST_SYNAPTICS_CLICKPAD_X220,
+	};
+	struct litest_device *devices[ARRAY_LENGTH(types)];
+	int added[ARRAY_LENGTH(types)] = { 0 };
+	int position[ARRAY_LENGTH(types)];
+	int last_position = -1;
+	struct libinput_event *ev;
+
+	for (size_t i = 0; i < ARRAY_LENGTH(types); i++) {
+		devices[i] = litest_create(types[i], NULL, NULL, NULL, NULL);
+		position[i] = -1;
+	}
+
+	_unref_(udev) *udev = udev_new();
+	litest_assert_notnull(udev);
+
+	/* The same enumeration as the udev backend, to get the expected
+	 * order of our devices */
+	_unref_(udev_enumerate) *e = udev_enumerate_new(udev);
+	struct udev_list_entry *entry;
+	int idx = 0;
+	udev_enumerate_add_match_subsystem(e, "input");
+	udev_enumerate_scan_devices(e);
+	udev_list_entry_foreach(entry, udev_enumerate_get_list_entry(e)) {
+		const char *path = udev_list_entry_get_name(entry);
+		_unref_(udev_device) *ud = udev_device_new_from_syspath(udev, path);
+		const char *devnode = ud ? udev_device_get_devnode(ud) : NULL;
+
+		if (!devnode)
+			continue;
+
+		for (size_t i = 0; i < ARRAY_LENGTH(types); i++) {
+			const char *node =
+				libevdev_uinput_get_devnode(devices[i]->uinput);
+			if (streq(devnode, node))
+				position[i] = idx;
+		}
+		idx++;
+	}
+
+	_unref_(libinput) *li =
+		libinput_udev_create_context(&simple_interface, NULL, udev);
+	litest_assert_notnull(li);
+	litest_assert_int_eq(libinput_udev_assign_seat(li, "seat0"), 0);
+
+	litest_dispatch(li);
+	while ((ev = libinput_get_event(li))) {
+		if (libinput_event_get_type(ev) == LIBINPUT_EVENT_DEVICE_ADDED) {
+			struct libinput_device *device = libinput_event_get_device(ev);
+			_unref_(udev_device) *ud =
+				libinput_device_get_udev_device(device);
+			const char *devnode = udev_device_get_devnode(ud);
+
+			for (size_t i = 0; i < ARRAY_LENGTH(types); i++) {
+				const char *node =
+					libevdev_uinput_get_devnode(devices[i]->uinput);
+				if (streq(devnode, node)) {
+					added[i]++;
+					litest_assert_int_gt(position[i], last_position);
+					last_position = position[i];
+				}
+			}
+		}
+		libinput_event_destroy(ev);
+	}
+
+	for (size_t i = 0; i < ARRAY_LENGTH(types); i++) {
+		litest_assert_int_ne(position[i], -1);
+		litest_assert_int_eq(added[i], 1);
+		litest_device_destroy(devices[i]);
+	}
+}
+END_TEST
+
+struct trace_phases {
+	const char *sysname;
+	bool open;
+	bool read;
+	bool added;
+	bool dispatch;
+};
+
+static void
+trace_func(struct libinput *li,
+	   const char *device,
+	   const char *phase,
+	   unsigned int depth,
+	   uint64_t start_usec,
+	   uint64_t end_usec,
+	   void *user_data)
+{
+	struct trace_phases *phases = user_data;
+
+	litest_assert_int_ge(end_usec, start_usec);
+
+	if (!streq(device, phases->sysname))
+		return;
+
+	if (streq(phase, "open"))
+		phases->open = true;
+	else if (streq(phase, "libevdev"))
+		phases->read = true;
+	else if (streq(phase, "device added"))
+		phases->added = true;
+	else if (streq(phase, "dispatch init")) {
+		/* nested inside "device added" */
+		litest_assert_int_gt(depth, 0U);
+		phases->dispatch = true;
+	}
+}
+
+START_TEST(udev_trace_dump)
+{
+	struct litest_device *dev = litest_create(LITEST_MOUSE, NULL, NULL, NULL, NULL);
+	const char *devnode = libevdev_uinput_get_devnode(dev->uinput);
+	struct trace_phases phases = {
+		.sysname = safe_basename(devnode),
+	};
+
+	_unref_(udev) *udev = udev_new();
+	litest_assert_notnull(udev);
+
+	_unref_(libinput) *li =
+		libinput_udev_create_context(&simple_interface, NULL, udev);
+	litest_assert_notnull(li);
+	litest_assert_int_eq(libinput_udev_assign_seat(li, "seat0"), 0);
+	litest_drain_events(li);
+
+	libinput_trace_dump(li, trace_func, &phases);
+	litest_assert(phases.open);
+	litest_assert(phases.read);
+	litest_assert(phases.added);
+	litest_assert(phases.dispatch);
+
+	litest_device_destroy(dev);
+}
+END_TEST
+
+START_TEST(udev_device_removed)
+{
+	struct litest_device *mouse, *keyboard;
+
+	mouse = litest_create(LITEST_MOUSE, NULL, NULL, NULL, NULL);
+	keyboard = litest_create(LITEST_KEYBOARD, NULL, NULL, NULL, NULL);
+
+	_autofree_ char *mouse_sysname = safe_strdup(
+		safe_basename(libevdev_uinput_get_devnode(mouse->uinput)));
+	_autofree_ char *keyboard_sysname = safe_strdup(
+		safe_basename(libevdev_uinput_get_devnode(keyboard->uinput)));
+
+	_unref_(udev) *udev = udev_new();
+	litest_assert_notnull(udev);
+
+	_unref_(libinput) *li =
+		libinput_udev_create_context(&simple_interface, NULL, udev);
+	litest_assert_notnull(li);
+	litest_assert_int_eq(libinput_udev_assign_seat(li, "seat0"), 0);
+	litest_drain_events(li);
+
+	/* Only the unplugged device may be removed */
+	litest_device_destroy(mouse);
+
+	while (true) {
+		litest_wait_for_event_of_type(li, LIBINPUT_EVENT_DEVICE_REMOVED);
+		_destroy_(libinput_event) *event = libinput_get_event(li);
+		litest_assert_event_type(event, LIBINPUT_EVENT_DEVICE_REMOVED);
+
+		const char *sysname =
+			libinput_device_get_sysname(libinput_event_get_device(event));
+		litest_assert_str_ne(sysname, keyboard_sysname);
+		if (streq(sysname, mouse_sysname))
+			break;
+	}
+
+	litest_device_destroy(keyboard);
+
+	while (true) {
+		litest_wait_for_event_of_type(li, LIBINPUT_EVENT_DEVICE_REMOVED);
+		_destroy_(libinput_event) *event = libinput_get_event(li);
+		litest_assert_event_type(event, LIBINPUT_EVENT_DEVICE_REMOVED);
+
+		const char *sysname =
+			libinput_device_get_sysname(libinput_event_get_device(event));
+		if (streq(sysname, keyboard_sysname))
+			break;
+	}
+}
+END_TEST
+
 START_TEST(udev_path_add_device)
 {
 	struct libinput_device *device;
@@ -616,6 +813,10 @@ TEST_COLLECTION(udev)
 	litest_add_for_device(udev_device_sysname, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_for_device(udev_seat_recycle, LITEST_SYNAPTICS_CLICKPAD_X220);
 
+	litest_add_no_device(udev_enumerate_devices);
+	litest_add_no_device(udev_trace_dump);
+	litest_add_no_device(udev_device_removed);
+
 	litest_add_no_device(udev_path_add_device);
 	litest_add_for_device(udev_path_remove_device, LITEST_SYNAPTICS_CLICKPAD_X220);
 
@@ -322,6 +322,39 @@ START_TEST(bitfield_helpers)
 }
 END_TEST
 
+START_TEST(long_bit_iteration)
+{
+	unsigned long bits[NLONGS(200)] = { 0 };
+	const int set[] = { 0, 1, 31, 63, 64, 65, 127, 128, 199 };
+	size_t idx = 0;
+
+	litest_assert_int_eq(long_bit_find_next_set(bits, ARRAY_LENGTH(bits), 0), -1);
+
+	ARRAY_FOR_EACH(set, b)
+		long_set_bit(bits, *b);
+
+	long_for_each_bit_set(bits, ARRAY_LENGTH(bits), b) {
+		litest_assert_int_lt(idx, ARRAY_LENGTH(set));
+		litest_assert_int_eq(b, set[idx]);
+		idx++;
+	}
+	litest_assert_int_eq(idx, ARRAY_LENGTH(set));
+
+	litest_assert_int_eq(long_bit_find_next_set(bits, ARRAY_LENGTH(bits), 2), 31);
+	litest_assert_int_eq(long_bit_find_next_set(bits, ARRAY_LENGTH(bits), 66), 127);
+	litest_assert_int_eq(long_bit_find_next_set(bits, ARRAY_LENGTH(bits), 200), -1);
+
+	/* clearing bits during iteration */
+	idx = 0;
+	long_for_each_bit_set(bits, ARRAY_LENGTH(bits), b) {
+		long_clear_bit(bits, b);
+		idx++;
+	}
+	litest_assert_int_eq(idx, ARRAY_LENGTH(set));
+	litest_assert(!long_any_bit_set(bits, ARRAY_LENGTH(bits)));
+}
+END_TEST
+
 START_TEST(bitmask_test)
 {
 	{
@@ -3220,6 +3253,7 @@ main(void)
 	ADD_TEST(array_for_each);
 
 	ADD_TEST(bitfield_helpers);
+	ADD_TEST(long_bit_iteration);
 	ADD_TEST(bitmask_test);
 	ADD_TEST(matrix_helpers);
 	ADD_TEST(ratelimit_helpers);
@@ -50,9 +50,61 @@ static volatile sig_atomic_t stop = 0;
 static bool be_quiet = false;
 static bool compress_motion_events = false;
 static bool is_tty = false;
+static bool palm_stats = false;
+static struct libinput_device *palm_stats_devices[60];
 
 #define printq(...) ({ if (!be_quiet)  printf(__VA_ARGS__); })
 
+static void
+print_palm_check(struct libinput_device *device,
+		 const char *check,
+		 uint64_t evaluated,
+		 uint64_t triggered,
+		 uint64_t time_nsec,
+		 void *user_data)
+{
+	bool *first = user_data;
+
+	if (*first) {
+		printf("%-7s %s\n",
+		       libinput_device_get_sysname(device),
+		       libinput_device_get_name(device));
+		*first = false;
+	}
+
+	printf("        %-12s evaluated %10" PRIu64 "  triggered %8" PRIu64
+	       "  %10.3fms\n",
+	       check,
+	       evaluated,
+	       triggered,
+	       time_nsec / 1000000.0);
+}
+
+static void
+palm_stats_add_device(struct libinput_device *device)
+{
+	ARRAY_FOR_EACH(palm_stats_devices, d) {
+		if (*d == NULL) {
+			*d = libinput_device_ref(device);
+			return;
+		}
+	}
+}
+
+static void
+palm_stats_remove_device(struct libinput_device *device)
+{
+	ARRAY_FOR_EACH(palm_stats_devices, d) {
+		if (*d == device) {
+			bool first = true;
+
+			libinput_device_palm_stats_dump(*d, print_palm_check, &first);
+			libinput_device_unref(*d);
+			*d = NULL;
+		}
+	}
+}
+
 static int
 handle_and_print_events(struct libinput *li, const struct libinput_print_options *opts)
 {
@@ -108,6 +160,12 @@ handle_and_print_events(struct libinput *li, const struct libinput_print_options
 			case LIBINPUT_EVENT_DEVICE_ADDED:
 				tools_device_apply_config(libinput_event_get_device(ev),
 							  &options);
+				if (palm_stats)
+					palm_stats_add_device(device);
+				break;
+			case LIBINPUT_EVENT_DEVICE_REMOVED:
+				if (palm_stats)
+					palm_stats_remove_device(device);
 				break;
 			case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY: {
 				struct libinput_event_tablet_tool *tev =
@@ -178,6 +236,12 @@ mainloop(struct libinput *li)
 	}
 
 	printf("\n");
+
+	/* Print the stats of all devices still present */
+	ARRAY_FOR_EACH(palm_stats_devices, d) {
+		if (*d)
+			palm_stats_remove_device(*d);
+	}
 }
 
 static void
@@ -215,6 +279,7 @@ main(int argc, char **argv)
 			OPT_SHOW_KEYCODES,
 			OPT_QUIET,
 			OPT_COMPRESS_MOTION_EVENTS,
+			OPT_PALM_STATS,
 		};
 		/* clang-format off */
 		static struct option opts[] = {
@@ -227,6 +292,7 @@ main(int argc, char **argv)
 			{ "verbose",                   no_argument,       0, OPT_VERBOSE },
 			{ "quiet",                     no_argument,       0, OPT_QUIET },
 			{ "compress-motion-events",    no_argument,       0, OPT_COMPRESS_MOTION_EVENTS },
+			{ "palm-stats",                no_argument,       0, OPT_PALM_STATS },
 			{ 0, 0, 0, 0},
 		};
 		/* clang-format on */
@@ -278,6 +344,9 @@ main(int argc, char **argv)
 			/* We compress by using ansi escape sequences */
 			compress_motion_events = is_tty;
 			break;
+		case OPT_PALM_STATS:
+			palm_stats = true;
+			break;
 		default:
 			if (tools_parse_option(c, optarg, &options) != 0) {
 				usage(NULL);
@@ -551,13 +551,38 @@ print_device_notify(struct libinput_event *ev)
 	printf("\n");
 }
 
+static void
+print_trace_span(struct libinput *li,
+		 const char *device,
+		 const char *phase,
+		 unsigned int depth,
+		 uint64_t start_usec,
+		 uint64_t end_usec,
+		 void *user_data)
+{
+	uint64_t *first = user_data;
+
+	if (*first == 0)
+		*first = start_usec;
+
+	printf("%-16s %*s%-*s %8.2fms  (+%.2fms)\n",
+	       device,
+	       (int)depth * 2,
+	       "",
+	       40 - (int)min(depth * 2, 40U),
+	       phase,
+	       (end_usec - start_usec) / 1000.0,
+	       (start_usec - *first) / 1000.0);
+}
+
 static inline void
 usage(void)
 {
-	printf("Usage: libinput list-devices [--help|--version]\n");
+	printf("Usage: libinput list-devices [--help|--version|--timing]\n");
 	printf("\n"
 	       "--help ...... show this help and exit\n"
 	       "--version ... show version information and exit\n"
+	       "--timing .... print the time spent initializing each device\n"
 	       "\n");
 }
 
@@ -567,6 +592,7 @@ main(int argc, char **argv)
 	struct libinput *li;
 	struct libinput_event *ev;
 	bool grab = false;
+	bool timing = false;
 
 	while (1) {
 		int c;
@@ -574,11 +600,13 @@ main(int argc, char **argv)
 		enum {
 			OPT_HELP = 1,
 			OPT_VERBOSE,
+			OPT_TIMING,
 		};
 		static struct option opts[] = {
 			CONFIGURATION_OPTIONS,
 			{ "help", no_argument, 0, 'h' },
 			{ "verbose", no_argument, 0, OPT_VERBOSE },
+			{ "timing", no_argument, 0, OPT_TIMING },
 			{ 0, 0, 0, 0 }
 		};
 		c = getopt_long(argc, argv, "h", opts, &option_index);
@@ -592,6 +620,9 @@ main(int argc, char **argv)
 		case OPT_HELP:
 			usage();
 			return EXIT_SUCCESS;
+		case OPT_TIMING:
+			timing = true;
+			break;
 		default:
 			return EXIT_INVALID_USAGE;
 		}
@@ -629,6 +660,12 @@ main(int argc, char **argv)
 		libinput_dispatch(li);
 	}
 
+	if (timing) {
+		uint64_t first = 0;
+
+		libinput_trace_dump(li, print_trace_span, &first);
+	}
+
 	libinput_unref(li);
 
 	return EXIT_SUCCESS;
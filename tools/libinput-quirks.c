@@ -85,7 +85,10 @@ usage(void)
 	       "	Print the quirks for the given device\n"
 	       "\n"
 	       "  libinput quirks validate [--data-dir /path/to/quirks/dir]\n"
-	       "	Validate the database\n");
+	       "	Validate the database\n"
+	       "\n"
+	       "  libinput quirks compile [--data-dir /path/to/quirks/dir]\n"
+	       "	Compile the database into a binary image in the data directory\n");
 }
 
 static void
@@ -99,6 +102,7 @@ main(int argc, char **argv)
 {
 	const char *data_path = NULL, *override_file = NULL;
 	bool validate = false;
+	bool compile = false;
 
 	while (1) {
 		int c;
@@ -156,6 +160,13 @@ main(int argc, char **argv)
 			return EXIT_FAILURE;
 		}
 		validate = true;
+	} else if (streq(argv[optind], "compile")) {
+		optind++;
+		if (optind < argc) {
+			usage();
+			return EXIT_FAILURE;
+		}
+		compile = true;
 	} else {
 		fprintf(stderr, "Unnkown action '%s'\n", argv[optind]);
 		return EXIT_FAILURE;
@@ -188,6 +199,9 @@ main(int argc, char **argv)
 	if (validate)
 		return EXIT_SUCCESS;
 
+	if (compile)
+		return quirks_context_compile(quirks) ? EXIT_SUCCESS : EXIT_FAILURE;
+
 	_unref_(udev) *udev = udev_new();
 	if (!udev)
 		return EXIT_FAILURE;
@@ -26,12 +26,15 @@
 #include <assert.h>
 #include <errno.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <linux/input.h>
 
+#include "filter-private.h"
 #include "filter.h"
 #include "libinput-util.h"
 
@@ -146,6 +149,186 @@ mmps_to_upus(double mmps, int dpi)
 	return mmps * (dpi / 25.4) / 1e6;
 }
 
+/* units/µs → mm/s */
+static inline double
+upus_to_mmps(double upus, int dpi)
+{
+	return v_us2s(upus) / (dpi / 25.4);
+}
+
+struct replay_state {
+	uint64_t time;
+	struct device_float_coords delta;
+
+	/* touchpad position, only used if the device has no REL axes */
+	bool touch_down;
+	bool was_down;
+	bool have_position;
+	bool position_changed;
+	struct device_coords position;
+	struct device_coords last_position;
+};
+
+static void
+replay_flush_frame(struct motion_filter *filter,
+		   struct pointer_trackers *trackers,
+		   struct replay_state *state,
+		   int dpi)
+{
+	struct device_float_coords motion = state->delta;
+	struct normalized_coords norm, accel;
+	double velocity, factor = 0.0;
+	bool has_motion = false;
+
+	if (motion.x != 0.0 || motion.y != 0.0) {
+		has_motion = true;
+	} else if (state->touch_down && state->have_position) {
+		/* First frame of a touch only sets the position, a
+		 * delta requires two frames with the finger down */
+		if (!state->was_down) {
+			filter_restart(filter, NULL, state->time);
+			trackers_reset(trackers, state->time);
+		} else if (state->position_changed) {
+			motion.x = state->position.x - state->last_position.x;
+			motion.y = state->position.y - state->last_position.y;
+			has_motion = true;
+		}
+		state->last_position = state->position;
+	}
+
+	state->was_down = state->touch_down;
+	state->position_changed = false;
+	state->delta.x = 0.0;
+	state->delta.y = 0.0;
+
+	if (!has_motion)
+		return;
+
+	/* Velocity is calculated on the deltas normalized to 1000dpi,
+	 * same as the filters do internally */
+	norm = normalize_for_dpi(&motion, dpi);
+	trackers_feed(trackers,
+		      &(struct device_float_coords){ norm.x, norm.y },
+		      state->time);
+	velocity = trackers_velocity(trackers, state->time);
+
+	accel = filter_dispatch(filter, &motion, NULL, state->time);
+	if (!normalized_is_zero(norm))
+		factor = normalized_length(accel) / normalized_length(norm);
+
+	printf("%" PRIu64 ",%.3f,%.3f,%.4f,%.4f,%.4f,%.4f\n",
+	       state->time,
+	       motion.x,
+	       motion.y,
+	       upus_to_mmps(velocity, DEFAULT_MOUSE_DPI),
+	       factor,
+	       accel.x,
+	       accel.y);
+}
+
+/**
+ * Replay the motion of one device from a libinput record file.
+ *
+ * This is not a YAML parser, it merely picks up the evdev event lines
+ * (- [sec, usec, type, code, value]) of the device with the given index.
+ * Relative devices use REL_X/REL_Y, absolute devices (touchpads) use the
+ * ABS_X/ABS_Y deltas while BTN_TOUCH is down.
+ */
+static int
+replay_recording(struct motion_filter *filter,
+		 const char *path,
+		 unsigned int device_index,
+		 int dpi)
+{
+	_autofclose_ FILE *fp = NULL;
+	_autofree_ char *line = NULL;
+	size_t linesz = 0;
+	struct pointer_trackers trackers;
+	struct replay_state state = { 0 };
+	int device = -1;
+
+	if (streq(path, "-")) {
+		fp = fdopen(dup(STDIN_FILENO), "r");
+	} else {
+		fp = fopen(path, "r");
+	}
+	if (!fp) {
+		fprintf(stderr, "Failed to open %s: %m\n", path);
+		return 1;
+	}
+
+	trackers_init(&trackers, 2);
+
+	printf("# time(us),dx,dy,velocity(mm/s),factor,dx_accel,dy_accel\n");
+
+	while (getline(&line, &linesz, fp) != -1) {
+		const char *l = line;
+		unsigned long sec;
+		unsigned int usec;
+		int type, code, value;
+
+		while (*l == ' ')
+			l++;
+
+		if (strstartswith(l, "- node:")) {
+			device++;
+			continue;
+		}
+
+		if (device != (int)device_index || !strstartswith(l, "- ["))
+			continue;
+
+		if (sscanf(l,
+			   "- [%lu, %u, %d, %d, %d]",
+			   &sec,
+			   &usec,
+			   &type,
+			   &code,
+			   &value) != 5)
+			continue;
+
+		state.time = s2us(sec) + usec;
+
+		switch (type) {
+		case EV_REL:
+			if (code == REL_X)
+				state.delta.x += value;
+			else if (code == REL_Y)
+				state.delta.y += value;
+			break;
+		case EV_ABS:
+			if (code == ABS_X) {
+				state.position.x = value;
+				state.position_changed = true;
+			} else if (code == ABS_Y) {
+				state.position.y = value;
+				state.position_changed = true;
+			} else {
+				break;
+			}
+			state.have_position = true;
+			break;
+		case EV_KEY:
+			if (code == BTN_TOUCH)
+				state.touch_down = !!value;
+			break;
+		case EV_SYN:
+			if (code == SYN_REPORT)
+				replay_flush_frame(filter, &trackers, &state, dpi);
+			break;
+		}
+	}
+
+	trackers_free(&trackers);
+
+	if (device < (int)device_index) {
+		fprintf(stderr, "Device %u not found in %s\n", device_index, path);
+		return 1;
+	}
+
+	return 0;
+}
+
 static void
 print_accel_func(struct motion_filter *filter, accel_profile_func_t profile, int dpi)
 {
@@ -178,15 +361,19 @@ usage(void)
 	       program_invocation_short_name);
 	printf("\n"
 	       "Options:\n"
-	       "--mode=<accel|motion|delta|sequence> \n"
+	       "--mode=<accel|motion|delta|sequence|replay> \n"
 	       "	accel    ... print accel factor (default)\n"
 	       "	motion   ... print motion to accelerated motion\n"
 	       "	delta    ... print delta to accelerated delta\n"
 	       "	sequence ... print motion for custom delta sequence\n"
+	       "	replay   ... print CSV of the motion in a libinput record file\n"
 	       "--maxdx=<double>  ... in motion mode only. Stop increasing dx at maxdx\n"
 	       "--steps=<double>  ... in motion and delta modes only. Increase dx by step each round\n"
 	       "--speed=<double>  ... accel speed [-1, 1], default 0\n"
 	       "--dpi=<int>	... device resolution in DPI (default: 1000)\n"
+	       "--replay=<file>  ... libinput record file to replay, implies --mode=replay.\n"
+	       "                     Use - to read the recording from stdin\n"
+	       "--replay-device=<int>  ... index of the device in the recording (default: 0)\n"
 	       "--filter=<linear|low-dpi|touchpad|x230|trackpoint> \n"
 	       "	linear	  ... the default motion filter\n"
 	       "	low-dpi	  ... low-dpi filter, use --dpi with this argument\n"
@@ -204,6 +391,10 @@ usage(void)
 	       "If stdin is a pipe, mode defaults to 'sequence' and the pipe is read \n"
 	       "for delta coordinates\n"
 	       "\n"
+	       "In replay mode, REL_X/REL_Y are used for relative devices and the\n"
+	       "ABS_X/ABS_Y deltas while BTN_TOUCH is down for touchpads. The output\n"
+	       "is one CSV line per frame with motion, using the event timestamps.\n"
+	       "\n"
 	       "Delta coordinates passed into this tool must be in dpi as\n"
 	       "specified by the --dpi argument\n"
 	       "\n"
@@ -215,6 +406,7 @@ enum mode {
 	MOTION,
 	DELTA,
 	SEQUENCE,
+	REPLAY,
 };
 
 int
@@ -229,6 +421,9 @@ main(int argc, char **argv)
 	int dpi = 1000;
 	bool use_averaging = false;
 	const char *filter_type = "linear";
+	const char *replay_file = NULL;
+	unsigned int replay_device = 0;
+	int rc = 0;
 	accel_profile_func_t profile = NULL;
 	double tp_multiplier = 1.0;
 	struct libinput_config_accel_custom_func custom_func = {
@@ -250,6 +445,8 @@ main(int argc, char **argv)
 		OPT_FILTER,
 		OPT_CUSTOM_POINTS,
 		OPT_CUSTOM_STEP,
+		OPT_REPLAY,
+		OPT_REPLAY_DEVICE,
 	};
 
 	while (1) {
@@ -266,6 +463,8 @@ main(int argc, char **argv)
 			{ "filter", 1, 0, OPT_FILTER },
 			{ "custom-points", 1, 0, OPT_CUSTOM_POINTS },
 			{ "custom-step", 1, 0, OPT_CUSTOM_STEP },
+			{ "replay", 1, 0, OPT_REPLAY },
+			{ "replay-device", 1, 0, OPT_REPLAY_DEVICE },
 			{ 0, 0, 0, 0 }
 		};
 
@@ -287,6 +486,8 @@ main(int argc, char **argv)
 				mode = DELTA;
 			else if (streq(optarg, "sequence"))
 				mode = SEQUENCE;
+			else if (streq(optarg, "replay"))
+				mode = REPLAY;
 			else {
 				usage();
 				return 1;
@@ -341,6 +542,16 @@ main(int argc, char **argv)
 		case OPT_CUSTOM_STEP:
 			custom_func.step = strtod(optarg, NULL);
 			break;
+		case OPT_REPLAY:
+			replay_file = optarg;
+			mode = REPLAY;
+			break;
+		case OPT_REPLAY_DEVICE:
+			if (!safe_atou(optarg, &replay_device)) {
+				usage();
+				return 1;
+			}
+			break;
 		default:
 			usage();
 			exit(1);
@@ -387,7 +598,12 @@ main(int argc, char **argv)
 	assert(filter != NULL);
 	filter_set_speed(filter, speed);
 
-	if (!isatty(STDIN_FILENO)) {
+	if (mode == REPLAY) {
+		if (!replay_file) {
+			usage();
+			return 1;
+		}
+	} else if (!isatty(STDIN_FILENO)) {
 		char buf[12];
 		mode = SEQUENCE;
 		nevents = 0;
@@ -420,10 +636,13 @@ main(int argc, char **argv)
 	case SEQUENCE:
 		print_ptraccel_sequence(filter, nevents, custom_deltas);
 		break;
+	case REPLAY:
+		rc = replay_recording(filter, replay_file, replay_device, dpi);
+		break;
 	}
 
 	libinput_config_accel_destroy(accel_config);
 	filter_destroy(filter);
 
-	return 0;
+	return rc;
 }